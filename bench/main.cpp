@@ -0,0 +1,558 @@
+// jobject 微基准测试
+//
+// 用法：jobject_bench [名称过滤] [每项最短运行毫秒数]
+// 每项基准自动倍增迭代次数直到运行时间达到下限，输出每次操作的耗时、
+// 分配次数与分配字节数。分配统计来自本程序替换的全局 operator new，
+// 元素缓冲区等直接使用 malloc/realloc 的分配不计入。
+#include "../src/JObject.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace jobject;
+using namespace jobject::utils;
+
+// =======================
+// 分配统计
+// =======================
+
+namespace {
+
+size_t g_allocations = 0;
+size_t g_allocatedBytes = 0;
+
+void* countedAlloc(size_t size) {
+    ++g_allocations;
+    g_allocatedBytes += size;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    ++g_allocations;
+    g_allocatedBytes += size;
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// =======================
+// 基准框架
+// =======================
+
+namespace {
+
+// 阻止编译器优化掉基准中计算出的值
+template <typename T> void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Options {
+    const char* filter = nullptr;
+    double minMillis = 200;
+};
+
+Options g_options;
+
+/**
+ * @brief Run one benchmark and print its per-operation cost.
+ *
+ * body(n) must perform exactly n operations. Setup that should not be
+ * measured belongs in setup(n), which runs before every timed batch and
+ * returns the state passed to body.
+ */
+template <typename Setup, typename Body>
+void runBenchmark(const char* name, Setup setup, Body body) {
+    if (g_options.filter && !std::strstr(name, g_options.filter)) {
+        return;
+    }
+
+    size_t iterations = 1;
+    while (true) {
+        auto state = setup(iterations);
+        const size_t allocations = g_allocations;
+        const size_t bytes = g_allocatedBytes;
+        const auto start = std::chrono::steady_clock::now();
+        body(state, iterations);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const size_t allocated = g_allocations - allocations;
+        const size_t allocatedBytes = g_allocatedBytes - bytes;
+
+        const double nanos =
+            std::chrono::duration<double, std::nano>(elapsed).count();
+        if (nanos >= g_options.minMillis * 1e6 || iterations >= (1u << 30)) {
+            const double n = static_cast<double>(iterations);
+            std::printf("%-40s %12.1f ns/op %10.2f allocs/op %12.1f B/op  (%zu ops)\n",
+                        name, nanos / n, allocated / n, allocatedBytes / n,
+                        iterations);
+            return;
+        }
+        // 按已测得的速度估算达到下限所需的次数，每轮增长 2 到 10 倍
+        const double scale = nanos > 0 ? g_options.minMillis * 1e6 / nanos : 100;
+        iterations = static_cast<size_t>(
+            static_cast<double>(iterations) * std::min(10.0, std::max(2.0, scale * 1.2)));
+    }
+}
+
+template <typename Body> void runBenchmark(const char* name, Body body) {
+    runBenchmark(name, [](size_t) { return 0; },
+                 [&](int, size_t n) { body(n); });
+}
+
+std::vector<std::string> makeKeys(size_t count, const char* prefix) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys.push_back(prefix + std::to_string(i));
+    }
+    return keys;
+}
+
+Ref<JArray> makeIntArray(size_t count) {
+    auto array = createArray();
+    for (size_t i = 0; i < count; ++i) {
+        array->Push(static_cast<int32_t>(i));
+    }
+    return array;
+}
+
+// =======================
+// 基准项
+// =======================
+
+void benchProperties() {
+    auto obj = createObject();
+    obj->setProperty("id", static_cast<int32_t>(1));
+    obj->setProperty("name", createString("n"));
+    obj->setProperty("value", 1.5);
+    const std::string key = "value";
+    const Atom atom = Atom::intern("value");
+
+    runBenchmark("object/setProperty(string)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            obj->setProperty(key, static_cast<int32_t>(i));
+        }
+    });
+    runBenchmark("object/getProperty(string)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(obj->getProperty(key));
+        }
+    });
+    runBenchmark("object/getProperty(atom)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(obj->getProperty(atom));
+        }
+    });
+    runBenchmark("object/getProperty(missing)", [&](size_t n) {
+        const std::string missing = "missing";
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(obj->getProperty(missing));
+        }
+    });
+    runBenchmark("object/create+3 props", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            auto fresh = createObject();
+            fresh->setProperty("id", static_cast<int32_t>(i));
+            fresh->setProperty("name", static_cast<int32_t>(i));
+            fresh->setProperty("value", static_cast<int32_t>(i));
+            doNotOptimize(fresh);
+        }
+    });
+}
+
+void benchDefineDelete(bool keepOrder) {
+    // 1000 个属性的字典模式对象上反复定义并删除同一批键
+    constexpr size_t kBase = 1000;
+    constexpr size_t kBatch = 100;
+    const auto baseKeys = makeKeys(kBase, "k");
+    const auto batchKeys = makeKeys(kBatch, "t");
+    auto obj = createObject();
+    obj->keepOrder(keepOrder);
+    for (const auto& key : baseKeys) {
+        obj->setProperty(key, static_cast<int32_t>(1));
+    }
+
+    PropertyDescriptor descriptor;
+    descriptor.value = static_cast<int32_t>(2);
+    const char* name = keepOrder ? "object/define+delete(keepOrder=on)"
+                                 : "object/define+delete(keepOrder=off)";
+    runBenchmark(name, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const auto& key = batchKeys[i % kBatch];
+            obj->defineProperty(key, descriptor);
+            obj->deleteProperty(key);
+        }
+    });
+}
+
+void benchArray() {
+    runBenchmark("array/push", [](size_t n) {
+        auto array = createArray();
+        for (size_t i = 0; i < n; ++i) {
+            array->Push(static_cast<int32_t>(i));
+        }
+        doNotOptimize(array);
+    });
+    runBenchmark(
+        "array/shift(drain)", [](size_t n) { return makeIntArray(n); },
+        [](const Ref<JArray>& array, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                doNotOptimize(array->Shift());
+            }
+        });
+    runBenchmark("array/unshift", [](size_t n) {
+        auto array = createArray();
+        for (size_t i = 0; i < n; ++i) {
+            const ValueVariant item = static_cast<int32_t>(i);
+            array->Unshift(&item, 1);
+        }
+        doNotOptimize(array);
+    });
+    runBenchmark("array/queue(push+shift)", [](size_t n) {
+        auto array = makeIntArray(1000);
+        for (size_t i = 0; i < n; ++i) {
+            array->Push(static_cast<int32_t>(i));
+            doNotOptimize(array->Shift());
+        }
+    });
+    runBenchmark(
+        "array/splice(middle,10k)",
+        [](size_t) { return makeIntArray(10000); },
+        [](const Ref<JArray>& array, size_t n) {
+            const ValueVariant item = static_cast<int32_t>(-1);
+            for (size_t i = 0; i < n; ++i) {
+                doNotOptimize(array->Splice(array->Size() / 2, 1, &item, 1));
+            }
+        });
+    runBenchmark(
+        "array/splice(middle,100k)",
+        [](size_t) { return makeIntArray(100000); },
+        [](const Ref<JArray>& array, size_t n) {
+            const ValueVariant items[] = {static_cast<int32_t>(-1),
+                                          static_cast<int32_t>(-2)};
+            for (size_t i = 0; i < n; ++i) {
+                const size_t start = (i * 7919) % array->Size();
+                doNotOptimize(array->Splice(start, 1 + i % 2, items, 1 + (i + 1) % 2));
+            }
+        });
+    auto large = makeIntArray(100000);
+    runBenchmark("array/slice(100 of 100k)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(large->Slice(i % 99900, i % 99900 + 100));
+        }
+    });
+    auto records = createArray();
+    for (size_t i = 0; i < 100000; ++i) {
+        records->Push(createObject());
+    }
+    runBenchmark("array/slice(page of 1000 objects)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const size_t start = (i * 1000) % 99000;
+            doNotOptimize(records->Slice(start, start + 1000));
+        }
+    });
+    runBenchmark("array/At", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(large->At(i % 100000));
+        }
+    });
+}
+
+void benchBuiltins() {
+    auto array = createArray();
+    auto str = createString("hello world");
+    runBenchmark("builtin/array.push lookup", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(array->getProperty("push"));
+        }
+    });
+    runBenchmark("builtin/string.indexOf lookup", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(str->getProperty("indexOf"));
+        }
+    });
+    // 读取不存在的用户属性：查完自有属性后沿原型链找不到任何内置方法
+    const std::string userKey = "customerId";
+    runBenchmark("builtin/array miss(user key)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(array->getProperty(userKey));
+        }
+    });
+    runBenchmark("builtin/string miss(user key)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(str->getProperty(userKey));
+        }
+    });
+    runBenchmark("builtin/string.indexOf call", [&](size_t n) {
+        auto indexOf = std::get<Ref<JFunction>>(str->getProperty("indexOf"));
+        const std::vector<ValueVariant> args = {createString("world")};
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(indexOf->Call(args));
+        }
+    });
+    runBenchmark("string/create", [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(createString("OK"));
+        }
+    });
+    // 日志拼装：一条消息由 500 个片段逐个 concat 得到，最后读取一次内容
+    auto fragment = createString("fragment-0123456789 ");
+    runBenchmark("string/concat(500 fragments)", [&](size_t n) {
+        const std::vector<ValueVariant> args = {fragment};
+        for (size_t i = 0; i < n; ++i) {
+            Ref<JString> message = createString("");
+            for (int j = 0; j < 500; ++j) {
+                auto concat = std::get<Ref<JFunction>>(message->getProperty("concat"));
+                message = std::get<Ref<JString>>(concat->Call(args));
+            }
+            doNotOptimize(message->getValue().size());
+        }
+    });
+    // 分词：约 1 MB 的输入切分为 10000 个字段
+    std::string csv;
+    for (int i = 0; i < 10000; ++i) {
+        csv += "record-" + std::to_string(i) + std::string(90, 'x') + ",";
+    }
+    auto input = createString(csv);
+    runBenchmark("string/split(10k fields)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(input->Split(","));
+        }
+    });
+    // 过滤：在 4 KB 的日志正文中查找靠近末尾的关键字
+    std::string payload;
+    while (payload.size() < 4096) {
+        payload += "ts=1700000000 level=info msg=\"request served\" path=/api/items ";
+    }
+    payload += "status=timeout";
+    auto body = createString(payload);
+    runBenchmark("string/indexOf(4KB, std::string_view::find)", [&](size_t n) {
+        const std::string_view text = body->view();
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(text.find("status=timeout"));
+        }
+    });
+    runBenchmark("string/indexOf(4KB)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(body->IndexOf("status=timeout"));
+        }
+    });
+    runBenchmark("string/indexOf(4KB, StringSearcher)", [&](size_t n) {
+        const StringSearcher searcher("status=timeout");
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(searcher.find(body->view()));
+        }
+    });
+    // 国际化文本：在约 100 KB 的中文字符串中按 UTF-16 下标随机读取
+    std::string cjk;
+    for (uint32_t i = 0; i < 30000; ++i) {
+        appendUtf8(cjk, 0x4E00 + i % 20000);
+        if (i % 10 == 0) cjk += ' ';
+    }
+    auto wide = createString(cjk);
+    runBenchmark("string/Utf16At(100KB CJK, random)", [&](size_t n) {
+        const size_t length = wide->Utf16Length();
+        size_t index = 12345;
+        for (size_t i = 0; i < n; ++i) {
+            index = (index * 2654435761u + 1) % length;
+            doNotOptimize(wide->Utf16At(index));
+        }
+    });
+    runBenchmark("string/lastIndexOf(4KB)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(body->LastIndexOf("msg=\"request failed\""));
+        }
+    });
+    // 按字符串值分组：每轮重新计数同一批 1000 个值（50 个不同的键）
+    std::vector<ValueVariant> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(createString("customer-" + std::to_string(i % 50) +
+                                    "/eu-west-1/standard-tier/region-key"));
+    }
+    runBenchmark("string/group-by(1000, rehash view)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::unordered_map<std::string_view, int> counts;
+            for (const auto& key : keys) {
+                ++counts[std::get<Ref<JString>>(key)->view()];
+            }
+            doNotOptimize(counts.size());
+        }
+    });
+    runBenchmark("string/group-by(1000, hashValue)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::unordered_map<ValueVariant, int, ValueHash, ValueEqual> counts;
+            for (const auto& key : keys) {
+                ++counts[key];
+            }
+            doNotOptimize(counts.size());
+        }
+    });
+    // 驻留后相同的键是同一个对象，比较只看指针
+    std::vector<ValueVariant> interned;
+    for (const auto& key : keys) {
+        interned.push_back(internString(std::get<Ref<JString>>(key)->view()));
+    }
+    runBenchmark("string/group-by(1000, hashValue, interned)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::unordered_map<ValueVariant, int, ValueHash, ValueEqual> counts;
+            for (const auto& key : interned) {
+                ++counts[key];
+            }
+            doNotOptimize(counts.size());
+        }
+    });
+}
+
+Ref<JObject> makeNestedRoot() {
+    auto c = createObject();
+    c->setProperty("c", static_cast<int32_t>(42));
+    auto b = createObject();
+    b->setProperty("b", c);
+    auto items = createArray();
+    items->Push(b);
+    auto root = createObject();
+    root->setProperty("a", items);
+    return root;
+}
+
+void benchPaths() {
+    auto root = makeNestedRoot();
+    runBenchmark("path/evalValue(string)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(evalValue(jvalue(root), "a[0].b.c"));
+        }
+    });
+    auto path = compilePath("a[0].b.c");
+    runBenchmark("path/evalValue(compiled)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(evalValue(jvalue(root), path));
+        }
+    });
+    runBenchmark("path/jvalue operator[] chain", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(jvalue(root)["a"][0]["b"]["c"]);
+        }
+    });
+}
+
+void benchIteration() {
+    auto obj = createObject();
+    for (const auto& key : makeKeys(32, "p")) {
+        obj->setProperty(key, static_cast<int32_t>(1));
+    }
+    runBenchmark("iterate/properties(32)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            for (const auto& [key, value] : jvalue(obj).properties()) {
+                doNotOptimize(value);
+            }
+        }
+    });
+    runBenchmark("iterate/forEachProperty(32)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            obj->forEachProperty(
+                [](const std::string&, const ValueVariant& value) {
+                    doNotOptimize(value);
+                });
+        }
+    });
+    auto array = makeIntArray(1000);
+    runBenchmark("iterate/elements(1000)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            for (const auto& value : jarray(jvalue(array)).elements()) {
+                doNotOptimize(value);
+            }
+        }
+    });
+}
+
+void benchJSON() {
+    std::string json = "[";
+    for (int i = 0; i < 1000; ++i) {
+        if (i) json += ",";
+        json += R"({"id":)" + std::to_string(i) +
+                R"(,"name":"item )" + std::to_string(i) +
+                R"(","score":1.5,"tags":["a","b"],"ok":true})";
+    }
+    json += "]";
+    runBenchmark("json/parse(1000 records)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(parseJSON(json));
+        }
+    });
+    // 字符串值高度重复时驻留可免去每条记录各自分配
+    std::string repeated = "[";
+    for (int i = 0; i < 1000; ++i) {
+        if (i) repeated += ",";
+        repeated += R"({"status":"active","region":"north-east-1","tier":"standard"})";
+    }
+    repeated += "]";
+    runBenchmark("json/parse(1000 repeated records)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(parseJSON(repeated));
+        }
+    });
+    JSONParseOptions interning;
+    interning.internStrings = true;
+    runBenchmark("json/parse(1000 repeated records, interned)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            doNotOptimize(parseJSON(repeated, interning));
+        }
+    });
+    const ValueVariant parsed = parseJSON(json);
+    JSONBufferSink sink;
+    runBenchmark("json/stringify(1000 records)", [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            sink.clear();
+            stringify(parsed, sink);
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && argv[1][0] != '\0') {
+        g_options.filter = argv[1];
+    }
+    if (argc > 2) {
+        g_options.minMillis = std::atof(argv[2]);
+    }
+
+#ifndef NDEBUG
+    std::printf("警告：基准程序以调试模式构建，结果不具代表性；"
+                "请使用 -DCMAKE_BUILD_TYPE=Release 配置\n");
+#endif
+
+    benchProperties();
+    benchDefineDelete(false);
+    benchDefineDelete(true);
+    benchArray();
+    benchBuiltins();
+    benchPaths();
+    benchIteration();
+    benchJSON();
+    return 0;
+}
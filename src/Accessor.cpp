@@ -10,18 +10,34 @@ namespace jobject {
 
 jvalue::jvalue(const ValueVariant &value) : value_(value) {}
 
-jvalue::jvalue(const ValueVariant &value,
-               const std::shared_ptr<JObject> &object,
-               const std::string &propertyName)
-    : value_(value), accessType_(AccessType::ObjectProperty),
-      objectTarget_(object), propertyName_(propertyName) {}
-
-jvalue::jvalue(const ValueVariant &value, const std::shared_ptr<JArray> &array,
-               size_t index)
-    : value_(value), accessType_(AccessType::ArrayIndex), arrayTarget_(array),
+jvalue::jvalue(const ValueVariant &value, JObject *object, Atom propertyName)
+    : value_(value), accessType_(AccessType::ObjectProperty), target_(object),
+      propertyName_(propertyName) {}
+
+jvalue::jvalue(const ValueVariant &value, JObject *object,
+               std::string propertyName)
+    : value_(value), accessType_(AccessType::ObjectProperty), target_(object),
+      pendingName_(std::move(propertyName)) {}
+
+jvalue::jvalue(const ValueVariant &value, JArray *array, size_t index)
+    : value_(value), accessType_(AccessType::ArrayIndex), target_(array),
       arrayIndex_(index) {}
 
 jvalue jvalue::operator[](const std::string &name) const {
+  auto objectLike = getObjectLike();
+  if (!objectLike) {
+    return jvalue(JUndefined{});
+  }
+  // 已驻留的属性名以原子绑定，避免每次访问复制属性名。读取不驻留新的名字：
+  // 没有原子时按名字查找（内置方法、length 等照常可读），写回时才驻留
+  const Atom key = Atom::find(name);
+  if (key.valid()) {
+    return (*this)[key];
+  }
+  return jvalue(objectLike->getProperty(name), objectLike, name);
+}
+
+jvalue jvalue::operator[](Atom name) const {
   auto objectLike = getObjectLike();
   if (!objectLike) {
     return jvalue(JUndefined{});
@@ -32,40 +48,24 @@ jvalue jvalue::operator[](const std::string &name) const {
 jvalue jvalue::operator[](size_t index) const {
   auto array = getArray();
   if (array) {
-    // 模拟JavaScript行为：先将index转为字符串，检查是否有对应属性
-    // （包括用户手动设置的命名属性及数组元素属性），有则通过属性系统返回；
-    // 否则按索引访问元素（越界时返回null）。
-    std::string key = std::to_string(index);
-    if (array->hasProperty(key)) {
-      return jvalue(array->getProperty(key),
-                    std::static_pointer_cast<JObject>(array), key);
-    }
+    // 数组元素按下标直接访问：越界读取返回 undefined，写入时自动扩容。
+    // 下标不经过属性名转换，也不会进入原子表。
     return jvalue(array->At(index), array, index);
   }
-  auto objectLike = getObjectLike();
-  if (objectLike) {
-    std::string key = std::to_string(index);
-    return jvalue(objectLike->getProperty(key), objectLike, key);
-  }
-  return jvalue(JUndefined{});
+  return (*this)[std::to_string(index)];
 }
 
 jvalue &jvalue::operator=(const ValueVariant &value) {
   value_ = value;
 
   if (accessType_ == AccessType::ObjectProperty) {
-    auto objectLike = objectTarget_.lock();
-    if (objectLike) {
-      objectLike->setProperty(propertyName_, value);
-    }
-    return *this;
-  }
-
-  if (accessType_ == AccessType::ArrayIndex) {
-    auto array = arrayTarget_.lock();
-    if (array) {
-      array->setElement(arrayIndex_, value);
+    if (propertyName_.valid()) {
+      target_->setProperty(propertyName_, value);
+    } else {
+      target_->setProperty(pendingName_, value);
     }
+  } else if (accessType_ == AccessType::ArrayIndex) {
+    static_cast<JArray *>(target_.get())->setElement(arrayIndex_, value);
   }
 
   return *this;
@@ -87,28 +87,28 @@ bool jvalue::isNull() const {
 
 bool jvalue::isNullish() const { return isUndefined() || isNull(); }
 
-std::shared_ptr<JObject> jvalue::getObjectLike() const {
-  if (auto objectPtr = std::get_if<std::shared_ptr<JObject>>(&value_)) {
-    return *objectPtr;
+JObject *jvalue::getObjectLike() const {
+  if (auto objectPtr = std::get_if<Ref<JObject>>(&value_)) {
+    return objectPtr->get();
   }
-  if (auto stringPtr = std::get_if<std::shared_ptr<JString>>(&value_)) {
-    return std::static_pointer_cast<JObject>(*stringPtr);
+  if (auto stringPtr = std::get_if<Ref<JString>>(&value_)) {
+    return stringPtr->get();
   }
-  if (auto arrayPtr = std::get_if<std::shared_ptr<JArray>>(&value_)) {
-    return std::static_pointer_cast<JObject>(*arrayPtr);
+  if (auto arrayPtr = std::get_if<Ref<JArray>>(&value_)) {
+    return arrayPtr->get();
   }
-  if (auto functionPtr = std::get_if<std::shared_ptr<JFunction>>(&value_)) {
-    return std::static_pointer_cast<JObject>(*functionPtr);
+  if (auto functionPtr = std::get_if<Ref<JFunction>>(&value_)) {
+    return functionPtr->get();
   }
-  if (auto datePtr = std::get_if<std::shared_ptr<JDate>>(&value_)) {
-    return std::static_pointer_cast<JObject>(*datePtr);
+  if (auto datePtr = std::get_if<Ref<JDate>>(&value_)) {
+    return datePtr->get();
   }
   return nullptr;
 }
 
-std::shared_ptr<JArray> jvalue::getArray() const {
-  if (auto arrayPtr = std::get_if<std::shared_ptr<JArray>>(&value_)) {
-    return *arrayPtr;
+JArray *jvalue::getArray() const {
+  if (auto arrayPtr = std::get_if<Ref<JArray>>(&value_)) {
+    return arrayPtr->get();
   }
   return nullptr;
 }
@@ -175,7 +175,7 @@ size_t jarray::length() const {
 jvalue::property_iterator::property_iterator() : index_(0) {}
 
 jvalue::property_iterator::property_iterator(
-    const std::shared_ptr<JObject> &obj,
+    const Ref<JObject> &obj,
     const std::shared_ptr<const std::vector<std::string>> &names,
     size_t index)
     : object_(obj), names_(names), index_(index) {}
@@ -183,7 +183,19 @@ jvalue::property_iterator::property_iterator(
 jvalue::property_iterator::reference
 jvalue::property_iterator::operator*() const {
   const auto &name = (*names_)[index_];
-  return {name, jvalue(object_->getProperty(name), object_, name)};
+  size_t index = 0;
+  if (object_->getType() == ValueType::Array &&
+      tryParseArrayIndex(name, index)) {
+    // 数组下标绑定到元素，避免把每个下标驻留为原子
+    auto *array = static_cast<JArray *>(object_.get());
+    return {name, jvalue(array->At(index), array, index)};
+  }
+  // 字典模式对象的属性名可能没有原子，迭代不为其驻留
+  const Atom key = Atom::find(name);
+  if (!key.valid()) {
+    return {name, jvalue(object_->getProperty(name), object_.get(), name)};
+  }
+  return {name, jvalue(object_->getProperty(key), object_.get(), key)};
 }
 
 jvalue::property_iterator &jvalue::property_iterator::operator++() {
@@ -232,8 +244,8 @@ jvalue::property_range jvalue::properties() const {
   // 只调用一次 getPropertyNames，begin 和 end 共享同一份数据
   auto names = std::make_shared<const std::vector<std::string>>(obj->getPropertyNames());
   auto sz = names->size();
-  return property_range(property_iterator(obj, names, 0),
-                        property_iterator(obj, names, sz));
+  return property_range(property_iterator(Ref<JObject>(obj), names, 0),
+                        property_iterator(Ref<JObject>(obj), names, sz));
 }
 
 // =======================
@@ -244,7 +256,7 @@ jvalue::iterator jvalue::begin() const {
   auto obj = getObjectLike();
   if (obj) {
     auto names = std::make_shared<const std::vector<std::string>>(obj->getPropertyNames());
-    return property_iterator(obj, names, 0);
+    return property_iterator(Ref<JObject>(obj), names, 0);
   }
   return property_iterator();
 }
@@ -254,7 +266,7 @@ jvalue::iterator jvalue::end() const {
   if (obj) {
     auto names = std::make_shared<const std::vector<std::string>>(obj->getPropertyNames());
     auto sz = names->size();
-    return property_iterator(obj, names, sz);
+    return property_iterator(Ref<JObject>(obj), names, sz);
   }
   return property_iterator();
 }
@@ -274,24 +286,24 @@ bool jvalue::empty() const { return size() == 0; }
 
 jarray::element_iterator::element_iterator() : index_(0) {}
 
-jarray::element_iterator::element_iterator(const std::shared_ptr<JArray> &arr,
+jarray::element_iterator::element_iterator(const Ref<JArray> &arr,
                                            size_t index)
     : array_(arr), index_(index) {}
 
 jarray::element_iterator::reference
 jarray::element_iterator::operator*() const {
-  // Route through public APIs to create an index-bound jvalue.
-  return jvalue(array_)[index_];
+  return jvalue(array_->At(index_), array_.get(), index_);
 }
 
 jarray::element_iterator &jarray::element_iterator::operator++() {
-  ++index_;
+  // 跳过稀疏数组中的空位
+  index_ = array_->NextIndex(index_ + 1);
   return *this;
 }
 
 jarray::element_iterator jarray::element_iterator::operator++(int) {
   auto tmp = *this;
-  ++index_;
+  ++*this;
   return tmp;
 }
 
@@ -323,14 +335,15 @@ jarray::element_range jarray::elements() const {
   if (!arr) {
     return element_range(element_iterator(), element_iterator());
   }
-  return element_range(element_iterator(arr, 0),
-                       element_iterator(arr, arr->Size()));
+  return element_range(
+      element_iterator(Ref<JArray>(arr), arr->NextIndex(0)),
+      element_iterator(Ref<JArray>(arr), arr->Size()));
 }
 
 jarray::iterator jarray::begin() const {
   auto arr = getArray();
   if (arr) {
-    return element_iterator(arr, 0);
+    return element_iterator(Ref<JArray>(arr), arr->NextIndex(0));
   }
   return element_iterator();
 }
@@ -338,7 +351,7 @@ jarray::iterator jarray::begin() const {
 jarray::iterator jarray::end() const {
   auto arr = getArray();
   if (arr) {
-    return element_iterator(arr, arr->Size());
+    return element_iterator(Ref<JArray>(arr), arr->Size());
   }
   return element_iterator();
 }
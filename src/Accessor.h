@@ -21,11 +21,12 @@ public:
   explicit jvalue(uint64_t v) : jvalue(ValueVariant(v)) {}
   explicit jvalue(double v) : jvalue(ValueVariant(v)) {}
   explicit jvalue(const std::string &v)
-      : jvalue(ValueVariant(std::make_shared<JString>(v))) {}
+      : jvalue(ValueVariant(makeRef<JString>(v))) {}
   explicit jvalue(const char *v)
-      : jvalue(ValueVariant(std::make_shared<JString>(v))) {}
+      : jvalue(ValueVariant(makeRef<JString>(v))) {}
 
   jvalue operator[](const std::string &name) const;
+  jvalue operator[](Atom name) const;
   jvalue operator[](size_t index) const;
 
   jvalue &operator=(const ValueVariant &value);
@@ -50,7 +51,7 @@ public:
     using reference = value_type;
 
     property_iterator();
-    property_iterator(const std::shared_ptr<JObject> &obj,
+    property_iterator(const Ref<JObject> &obj,
                       const std::shared_ptr<const std::vector<std::string>> &names,
                       size_t index);
 
@@ -61,7 +62,7 @@ public:
     bool operator!=(const property_iterator &other) const;
 
   private:
-    std::shared_ptr<JObject> object_;
+    Ref<JObject> object_;
     std::shared_ptr<const std::vector<std::string>> names_;
     size_t index_ = 0;
   };
@@ -101,19 +102,25 @@ private:
 
   ValueVariant value_;
   AccessType accessType_ = AccessType::None;
-  std::weak_ptr<JObject> objectTarget_;
-  std::weak_ptr<JArray> arrayTarget_;
-  std::string propertyName_;
+  // 绑定的写回目标（对象属性或数组元素）。以强引用保存：
+  // jvalue 是短生命周期的访问器，不会被对象持有，因此不会形成环。
+  Ref<JObject> target_;
+  Atom propertyName_;
+  // 读取时尚未驻留为原子的属性名：读取不驻留，写回时由 setProperty 驻留
+  std::string pendingName_;
   size_t arrayIndex_ = 0;
 
-  jvalue(const ValueVariant &value, const std::shared_ptr<JObject> &object,
-         const std::string &propertyName);
-  jvalue(const ValueVariant &value, const std::shared_ptr<JArray> &array,
-         size_t index);
+  jvalue(const ValueVariant &value, JObject *object, Atom propertyName);
+  jvalue(const ValueVariant &value, JObject *object, std::string propertyName);
+  jvalue(const ValueVariant &value, JArray *array, size_t index);
+
+  friend class jarray;
+  friend class utils::CompiledPath;
 
 protected:
-  std::shared_ptr<JObject> getObjectLike() const;
-  std::shared_ptr<JArray> getArray() const;
+  // 返回 value_ 持有的对象，不增加引用计数；生命周期由 value_ 保证
+  JObject *getObjectLike() const;
+  JArray *getArray() const;
 };
 
 // 数组访问器 - 派生自jvalue，提供数组操作方法
@@ -129,7 +136,7 @@ public:
 
   // ========== 迭代器支持 ==========
 
-  // 元素迭代器 - 迭代JArray的元素，产出 jvalue
+  // 元素迭代器 - 迭代JArray中存在的元素（跳过稀疏数组的空位），产出 jvalue
   class element_iterator {
   public:
     using iterator_category = std::forward_iterator_tag;
@@ -139,7 +146,7 @@ public:
     using reference = value_type;
 
     element_iterator();
-    element_iterator(const std::shared_ptr<JArray> &arr, size_t index);
+    element_iterator(const Ref<JArray> &arr, size_t index);
 
     reference operator*() const;
     element_iterator &operator++();
@@ -148,7 +155,7 @@ public:
     bool operator!=(const element_iterator &other) const;
 
   private:
-    std::shared_ptr<JArray> array_;
+    Ref<JArray> array_;
     size_t index_ = 0;
   };
 
@@ -0,0 +1,135 @@
+#include "Atom.h"
+
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace jobject {
+
+namespace {
+
+struct AtomEntry {
+  std::string name;
+  size_t hash = 0;
+  bool isArrayIndex = false;
+};
+
+// 原子表：条目按块分配且从不移动，按 id 读取条目无需加锁；
+// 名称到 id 的映射由读写锁保护。
+class AtomTable {
+public:
+  static constexpr uint32_t kBlockBits = 12;
+  static constexpr uint32_t kBlockSize = 1u << kBlockBits;
+  static constexpr uint32_t kMaxBlocks = 1u << 16;
+
+  static AtomTable &instance() {
+    // 有意泄漏，保证静态析构期间原子依然可用
+    static auto *table = new AtomTable();
+    return *table;
+  }
+
+  uint32_t find(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    return it == ids_.end() ? UINT32_MAX : it->second;
+  }
+
+  uint32_t intern(std::string_view name) {
+    const uint32_t existing = find(name);
+    if (existing != UINT32_MAX) {
+      return existing;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+
+    if (size_ == kMaxBlocks * kBlockSize) {
+      throw std::length_error("atom table is full");
+    }
+    const uint32_t id = size_;
+    auto &block = blocks_[id >> kBlockBits];
+    AtomEntry *entries = block.load(std::memory_order_relaxed);
+    if (!entries) {
+      entries = new AtomEntry[kBlockSize];
+      block.store(entries, std::memory_order_release);
+    }
+    AtomEntry &entry = entries[id & (kBlockSize - 1)];
+    entry.name.assign(name.data(), name.size());
+    entry.hash = hashPropertyName(entry.name);
+    size_t index = 0;
+    entry.isArrayIndex = tryParseArrayIndex(entry.name, index);
+
+    ids_.emplace(entry.name, id);
+    ++size_;
+    return id;
+  }
+
+  // id 只能来自 intern/find，条目在发布 id 之前已写完
+  const AtomEntry &entry(uint32_t id) const {
+    const AtomEntry *entries =
+        blocks_[id >> kBlockBits].load(std::memory_order_acquire);
+    return entries[id & (kBlockSize - 1)];
+  }
+
+private:
+  AtomTable() = default;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string_view, uint32_t> ids_;
+  std::unique_ptr<std::atomic<AtomEntry *>[]> blocksStorage_{
+      new std::atomic<AtomEntry *>[kMaxBlocks]()};
+  std::atomic<AtomEntry *> *blocks_ = blocksStorage_.get();
+  uint32_t size_ = 0;
+};
+
+} // namespace
+
+Atom Atom::intern(std::string_view name) {
+  return Atom(AtomTable::instance().intern(name));
+}
+
+Atom Atom::find(std::string_view name) {
+  return Atom(AtomTable::instance().find(name));
+}
+
+const std::string &Atom::str() const {
+  return AtomTable::instance().entry(id_).name;
+}
+
+size_t Atom::hash() const { return AtomTable::instance().entry(id_).hash; }
+
+bool Atom::isArrayIndex() const {
+  return AtomTable::instance().entry(id_).isArrayIndex;
+}
+
+bool tryParseArrayIndex(std::string_view name, size_t &outIndex) {
+  if (name.empty()) {
+    return false;
+  }
+  if (name.size() > 1 && name[0] == '0') {
+    return false;
+  }
+  for (const char ch : name) {
+    if (!std::isdigit(static_cast<unsigned char>(ch))) {
+      return false;
+    }
+  }
+  unsigned long long value = 0;
+  const auto result =
+      std::from_chars(name.data(), name.data() + name.size(), value);
+  if (result.ec != std::errc() || value > kMaxArrayIndex) {
+    return false;
+  }
+  outIndex = static_cast<size_t>(value);
+  return true;
+}
+
+} // namespace jobject
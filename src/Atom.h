@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace jobject {
+
+// 属性名原子：进程内驻留的属性名，以 32 位整数标识。
+// 哈希值与是否为数组下标在驻留时计算一次，之后按原子比较只需比较整数。
+// 原子一经驻留永不释放，适合作为固定的属性键（"id"、"ts"、"value" 等）。
+class Atom {
+public:
+  Atom() = default;
+
+  // 驻留 name 并返回对应原子；相同内容总是返回同一原子。
+  // 原子表已满（2^28 个原子）时抛出 std::length_error
+  static Atom intern(std::string_view name);
+  // 仅查找已驻留的原子，不存在时返回无效原子。只读路径使用，不扩大原子表
+  static Atom find(std::string_view name);
+
+  bool valid() const { return id_ != kInvalidId; }
+  uint32_t id() const { return id_; }
+
+  const std::string &str() const;
+  size_t hash() const;
+  // 是否为规范数组下标（如 "0"、"42"），数组按下标而非属性处理这类键
+  bool isArrayIndex() const;
+
+  bool operator==(Atom other) const { return id_ == other.id_; }
+  bool operator!=(Atom other) const { return id_ != other.id_; }
+
+private:
+  static constexpr uint32_t kInvalidId = UINT32_MAX;
+
+  explicit Atom(uint32_t id) : id_(id) {}
+
+  uint32_t id_ = kInvalidId;
+};
+
+// 属性名的哈希函数，原子的预计算哈希与之保持一致
+inline size_t hashPropertyName(std::string_view name) {
+  return std::hash<std::string_view>{}(name);
+}
+
+// 最大的数组下标 2^32 - 2：数组长度为 32 位，更大的数字属性名按普通属性保存
+constexpr size_t kMaxArrayIndex = 4294967294u;
+
+/**
+ * @brief Try to interpret a property name as a canonical array index.
+ *
+ * Accepts only pure decimal strings without leading zeros (except "0")
+ * whose value does not exceed kMaxArrayIndex, matching JavaScript's
+ * array index semantics.
+ *
+ * @param[in] name The property name to inspect.
+ * @param[out] outIndex Receives the parsed index when the name is an index.
+ * @return true if the name is a canonical array index, false otherwise.
+ */
+bool tryParseArrayIndex(std::string_view name, size_t &outIndex);
+
+} // namespace jobject
+
+namespace std {
+template <> struct hash<jobject::Atom> {
+  size_t operator()(jobject::Atom atom) const noexcept { return atom.id(); }
+};
+} // namespace std
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace jobject {
+
+// 内置名的哈希（FNV-1a），编译期与运行期结果相同。
+// 一次属性查找只计算一次，原型链上的各张表共用
+constexpr uint64_t hashBuiltinName(std::string_view name) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char ch : name) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// 完美哈希表的定位函数：种子与名字哈希混合后取高位，mask 为桶数减一
+constexpr size_t builtinBucket(uint64_t hash, uint64_t seed, size_t mask) {
+  return static_cast<size_t>(((hash ^ seed) * 0x9e3779b97f4a7c15ull) >> 40) &
+         mask;
+}
+
+// 内置名查找表的运行期视图，指向某张 BuiltinTable 的数据；
+// 不同大小的表以同一类型使用
+class BuiltinIndex {
+public:
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+  static constexpr uint8_t kEmpty = 0xFF;
+
+  constexpr BuiltinIndex() = default;
+  constexpr BuiltinIndex(const std::string_view *names, const uint8_t *buckets,
+                         size_t mask, uint64_t seed)
+      : names_(names), buckets_(buckets), mask_(mask), seed_(seed) {}
+
+  // hash 必须等于 hashBuiltinName(name)；默认构造的视图总是查找失败
+  uint32_t find(std::string_view name, uint64_t hash) const {
+    if (!buckets_) {
+      return kNotFound;
+    }
+    const uint8_t id = buckets_[builtinBucket(hash, seed_, mask_)];
+    return id != kEmpty && names_[id] == name ? id : kNotFound;
+  }
+
+private:
+  const std::string_view *names_ = nullptr;
+  const uint8_t *buckets_ = nullptr;
+  size_t mask_ = 0;
+  uint64_t seed_ = 0;
+};
+
+// 编译期生成的内置名完美哈希表：名字的下标即内置方法的编号。
+//
+// 构造时（constexpr）搜索一个种子，使各名字经种子混合后落入互不相同的桶，
+// 查找时只需一次乘法定位桶、一次字符串比较确认。找不到种子（如名字重复）
+// 时构造抛出异常，在常量求值中表现为编译错误
+template <size_t N> class BuiltinTable {
+public:
+  static constexpr uint32_t kNotFound = BuiltinIndex::kNotFound;
+
+  constexpr explicit BuiltinTable(const std::array<std::string_view, N> &names)
+      : names_(names) {
+    for (uint64_t seed = 0; seed < kMaxSeeds; ++seed) {
+      if (tryBuild(seed)) {
+        seed_ = seed;
+        return;
+      }
+    }
+    throw "BuiltinTable: no perfect hash seed found";
+  }
+
+  constexpr uint32_t find(std::string_view name) const {
+    const uint8_t id =
+        buckets_[builtinBucket(hashBuiltinName(name), seed_, kBuckets - 1)];
+    return id != kEmpty && names_[id] == name ? id : kNotFound;
+  }
+  // 须由静态存储期的表调用，视图在表的生命周期内有效
+  constexpr BuiltinIndex index() const {
+    return BuiltinIndex(names_.data(), buckets_.data(), kBuckets - 1, seed_);
+  }
+
+  static constexpr size_t size() { return N; }
+  constexpr std::string_view name(size_t id) const { return names_[id]; }
+
+private:
+  static_assert(N < 0xFF, "too many builtin names");
+
+  // 不小于 2N 的 2 的幂，负载不超过一半时很快能找到种子
+  static constexpr size_t bucketCount() {
+    size_t count = 2;
+    while (count < 2 * N) {
+      count *= 2;
+    }
+    return count;
+  }
+
+  static constexpr size_t kBuckets = bucketCount();
+  static constexpr uint8_t kEmpty = BuiltinIndex::kEmpty;
+  static constexpr uint64_t kMaxSeeds = 1 << 16;
+
+  constexpr bool tryBuild(uint64_t seed) {
+    for (auto &bucket : buckets_) {
+      bucket = kEmpty;
+    }
+    for (size_t id = 0; id < N; ++id) {
+      uint8_t &bucket = buckets_[builtinBucket(hashBuiltinName(names_[id]), seed,
+                                            kBuckets - 1)];
+      if (bucket != kEmpty) {
+        return false;
+      }
+      bucket = static_cast<uint8_t>(id);
+    }
+    return true;
+  }
+
+  std::array<std::string_view, N> names_;
+  std::array<uint8_t, kBuckets> buckets_{};
+  uint64_t seed_ = 0;
+};
+
+} // namespace jobject
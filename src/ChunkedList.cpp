@@ -0,0 +1,309 @@
+#include "ChunkedList.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+// 析构 CompactValue 中的对象引用需要完整的对象类型
+#include "JObject.h"
+
+namespace jobject {
+
+struct ChunkedList::Node {
+  explicit Node(bool leaf) : leaf(leaf) {}
+
+  bool leaf;
+  uint32_t count = 0; // 叶子：元素数；内部节点：子节点数
+  size_t size = 0;    // 子树中的元素总数
+};
+
+// 元素按字节搬移（CompactValue 只保存位模式），块内插入删除使用 memmove
+struct ChunkedList::Leaf : Node {
+  Leaf() : Node(true) {}
+  ~Leaf() {
+    for (uint32_t i = 0; i < count; ++i) {
+      values()[i].~CompactValue();
+    }
+  }
+
+  CompactValue *values() { return reinterpret_cast<CompactValue *>(storage); }
+  const CompactValue *values() const {
+    return reinterpret_cast<const CompactValue *>(storage);
+  }
+
+  alignas(CompactValue) unsigned char storage[kLeafCapacity *
+                                              sizeof(CompactValue)];
+};
+
+struct ChunkedList::Internal : Node {
+  Internal() : Node(false) {}
+
+  // 多一个位置容纳分裂前暂时超出的子节点
+  Node *children[kFanout + 1];
+};
+
+namespace {
+
+// 相邻两个节点合计不超过容量的四分之三时合并，避免在容量边界反复分裂合并
+constexpr size_t mergeLimit(size_t capacity) { return capacity * 3 / 4; }
+
+} // namespace
+
+size_t ChunkedList::size() const { return root_ ? root_->size : 0; }
+
+const CompactValue &ChunkedList::at(size_t index) const {
+  size_t start = 0;
+  const Leaf *leaf = descend(index, start);
+  return leaf->values()[index - start];
+}
+
+CompactValue &ChunkedList::at(size_t index) {
+  size_t start = 0;
+  Leaf *leaf = findLeaf(index, start);
+  return leaf->values()[index - start];
+}
+
+void ChunkedList::forEach(
+    size_t begin, size_t end,
+    const std::function<void(const CompactValue &)> &visit) const {
+  if (root_ && begin < end) {
+    visitRange(root_, begin, end, visit);
+  }
+}
+
+void ChunkedList::visitRange(
+    const Node *node, size_t begin, size_t end,
+    const std::function<void(const CompactValue &)> &visit) {
+  if (node->leaf) {
+    const CompactValue *values = static_cast<const Leaf *>(node)->values();
+    for (size_t i = begin; i < end; ++i) {
+      visit(values[i]);
+    }
+    return;
+  }
+  // 只进入与 [begin, end) 相交的子树，下标换算为子树内的相对位置
+  const auto *internal = static_cast<const Internal *>(node);
+  size_t start = 0;
+  for (uint32_t i = 0; i < internal->count && start < end; ++i) {
+    const Node *child = internal->children[i];
+    const size_t childEnd = start + child->size;
+    if (childEnd > begin) {
+      visitRange(child, std::max(begin, start) - start,
+                 std::min(end, childEnd) - start, visit);
+    }
+    start = childEnd;
+  }
+}
+
+ChunkedList::Leaf *ChunkedList::findLeaf(size_t index, size_t &start) {
+  if (cachedLeaf_ && index >= cachedStart_ &&
+      index - cachedStart_ < cachedLeaf_->count) {
+    start = cachedStart_;
+    return cachedLeaf_;
+  }
+  cachedLeaf_ = descend(index, start);
+  cachedStart_ = start;
+  return cachedLeaf_;
+}
+
+ChunkedList::Leaf *ChunkedList::descend(size_t index, size_t &start) const {
+  Node *node = root_;
+  start = 0;
+  while (!node->leaf) {
+    auto *internal = static_cast<Internal *>(node);
+    uint32_t i = 0;
+    while (index - start >= internal->children[i]->size) {
+      start += internal->children[i]->size;
+      ++i;
+    }
+    node = internal->children[i];
+  }
+  return static_cast<Leaf *>(node);
+}
+
+void ChunkedList::insert(size_t pos, const CompactValue &value) {
+  cachedLeaf_ = nullptr;
+  if (!root_) {
+    root_ = new Leaf();
+  }
+  if (Node *sibling = insertAt(root_, pos, value)) {
+    auto *root = new Internal();
+    root->children[0] = root_;
+    root->children[1] = sibling;
+    root->count = 2;
+    root->size = root_->size + sibling->size;
+    root_ = root;
+  }
+}
+
+ChunkedList::Node *ChunkedList::insertAt(Node *node, size_t pos,
+                                         const CompactValue &value) {
+  if (node->leaf) {
+    auto *leaf = static_cast<Leaf *>(node);
+    Leaf *sibling = nullptr;
+    Leaf *target = leaf;
+    if (leaf->count == kLeafCapacity) {
+      // 满块对半分裂，右半移入新块
+      sibling = new Leaf();
+      const uint32_t half = kLeafCapacity / 2;
+      std::memcpy(static_cast<void *>(sibling->values()), leaf->values() + half,
+                  (leaf->count - half) * sizeof(CompactValue));
+      sibling->count = leaf->count - half;
+      sibling->size = sibling->count;
+      leaf->count = half;
+      leaf->size = half;
+      if (pos > half) {
+        pos -= half;
+        target = sibling;
+      }
+    }
+    CompactValue *values = target->values();
+    std::memmove(static_cast<void *>(values + pos + 1), values + pos,
+                 (target->count - pos) * sizeof(CompactValue));
+    new (values + pos) CompactValue(value);
+    ++target->count;
+    target->size = target->count;
+    return sibling;
+  }
+
+  auto *internal = static_cast<Internal *>(node);
+  uint32_t i = 0;
+  while (i + 1 < internal->count && pos > internal->children[i]->size) {
+    pos -= internal->children[i]->size;
+    ++i;
+  }
+  ++internal->size;
+  Node *split = insertAt(internal->children[i], pos, value);
+  if (!split) {
+    return nullptr;
+  }
+  std::copy_backward(internal->children + i + 1,
+                     internal->children + internal->count,
+                     internal->children + internal->count + 1);
+  internal->children[i + 1] = split;
+  ++internal->count;
+  if (internal->count <= kFanout) {
+    return nullptr;
+  }
+
+  auto *sibling = new Internal();
+  const uint32_t half = internal->count / 2;
+  sibling->count = internal->count - half;
+  std::copy(internal->children + half, internal->children + internal->count,
+            sibling->children);
+  internal->count = half;
+  for (uint32_t j = 0; j < sibling->count; ++j) {
+    sibling->size += sibling->children[j]->size;
+  }
+  internal->size -= sibling->size;
+  return sibling;
+}
+
+void ChunkedList::erase(size_t pos, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  cachedLeaf_ = nullptr;
+  eraseRange(root_, pos, count);
+  // 根只剩一个子节点时降低高度
+  while (!root_->leaf && root_->count == 1) {
+    auto *root = static_cast<Internal *>(root_);
+    root_ = root->children[0];
+    delete root;
+  }
+  if (root_->size == 0) {
+    clear();
+  }
+}
+
+void ChunkedList::eraseRange(Node *node, size_t pos, size_t count) {
+  node->size -= count;
+  if (node->leaf) {
+    auto *leaf = static_cast<Leaf *>(node);
+    CompactValue *values = leaf->values();
+    for (size_t i = pos; i < pos + count; ++i) {
+      values[i].~CompactValue();
+    }
+    std::memmove(static_cast<void *>(values + pos), values + pos + count,
+                 (leaf->count - pos - count) * sizeof(CompactValue));
+    leaf->count -= static_cast<uint32_t>(count);
+    return;
+  }
+
+  auto *internal = static_cast<Internal *>(node);
+  uint32_t i = 0;
+  while (pos >= internal->children[i]->size) {
+    pos -= internal->children[i]->size;
+    ++i;
+  }
+  while (count > 0) {
+    Node *child = internal->children[i++];
+    const size_t n = std::min(count, child->size - pos);
+    eraseRange(child, pos, n);
+    count -= n;
+    pos = 0;
+  }
+  compact(internal);
+}
+
+void ChunkedList::compact(Internal *node) {
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < node->count; ++i) {
+    Node *child = node->children[i];
+    if (child->size == 0) {
+      destroy(child);
+      continue;
+    }
+    if (kept > 0) {
+      Node *previous = node->children[kept - 1];
+      if (child->leaf) {
+        auto *left = static_cast<Leaf *>(previous);
+        auto *right = static_cast<Leaf *>(child);
+        if (left->count + right->count <= mergeLimit(kLeafCapacity)) {
+          std::memcpy(static_cast<void *>(left->values() + left->count),
+                      right->values(), right->count * sizeof(CompactValue));
+          left->count += right->count;
+          left->size = left->count;
+          right->count = 0;
+          delete right;
+          continue;
+        }
+      } else {
+        auto *left = static_cast<Internal *>(previous);
+        auto *right = static_cast<Internal *>(child);
+        if (left->count + right->count <= mergeLimit(kFanout)) {
+          std::copy(right->children, right->children + right->count,
+                    left->children + left->count);
+          left->count += right->count;
+          left->size += right->size;
+          delete right;
+          continue;
+        }
+      }
+    }
+    node->children[kept++] = child;
+  }
+  node->count = kept;
+}
+
+void ChunkedList::clear() {
+  if (root_) {
+    destroy(root_);
+    root_ = nullptr;
+  }
+  cachedLeaf_ = nullptr;
+}
+
+void ChunkedList::destroy(Node *node) {
+  if (node->leaf) {
+    delete static_cast<Leaf *>(node);
+    return;
+  }
+  auto *internal = static_cast<Internal *>(node);
+  for (uint32_t i = 0; i < internal->count; ++i) {
+    destroy(internal->children[i]);
+  }
+  delete internal;
+}
+
+} // namespace jobject
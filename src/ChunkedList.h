@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "CompactValue.h"
+
+namespace jobject {
+
+// 大数组的分块元素序列：计数 B+ 树。
+//
+// 叶子是最多 kLeafCapacity 个元素的连续块，内部节点最多 kFanout 个子节点，
+// 每个节点记录子树中的元素总数。按下标访问、在任意位置插入与删除都是
+// O(log n)，只在一个块内搬移元素，不再整体移动后半段。
+// 写入路径缓存最近访问的叶子，顺序写入时连续命中同一个块，均摊 O(1)。
+// const 访问不读写缓存，多个线程可以同时读取同一个序列；
+// 顺序读取一段元素使用 forEach，逐块访问而不逐个定位。
+class ChunkedList {
+public:
+  static constexpr size_t kLeafCapacity = 512;
+  static constexpr size_t kFanout = 32;
+
+  ChunkedList() = default;
+  ChunkedList(const ChunkedList &) = delete;
+  ChunkedList &operator=(const ChunkedList &) = delete;
+  ~ChunkedList() { clear(); }
+
+  size_t size() const;
+
+  // 要求 index < size()
+  const CompactValue &at(size_t index) const;
+  CompactValue &at(size_t index);
+  // 依次访问 [begin, end) 范围内的元素，要求 end <= size()
+  void forEach(size_t begin, size_t end,
+               const std::function<void(const CompactValue &)> &visit) const;
+
+  // 在 pos 之前插入，要求 pos <= size()
+  void insert(size_t pos, const CompactValue &value);
+  // 删除 [pos, pos + count)，要求 pos + count <= size()
+  void erase(size_t pos, size_t count);
+  void clear();
+
+private:
+  struct Node;
+  struct Leaf;
+  struct Internal;
+
+  static void destroy(Node *node);
+  // 插入后节点分裂时返回新的右兄弟
+  static Node *insertAt(Node *node, size_t pos, const CompactValue &value);
+  static void eraseRange(Node *node, size_t pos, size_t count);
+  // 删除空的子节点并合并过小的相邻子节点
+  static void compact(Internal *node);
+  static void visitRange(const Node *node, size_t begin, size_t end,
+                         const std::function<void(const CompactValue &)> &visit);
+  // 自根向下定位 index 所在的叶子，start 为叶子第一个元素的下标
+  Leaf *descend(size_t index, size_t &start) const;
+  // 同 descend，先查缓存；只在独占访问的写入路径上使用
+  Leaf *findLeaf(size_t index, size_t &start);
+
+  Node *root_ = nullptr;
+  // 最近写入访问的叶子及其第一个元素的下标，结构变化时失效
+  Leaf *cachedLeaf_ = nullptr;
+  size_t cachedStart_ = 0;
+};
+
+} // namespace jobject
@@ -0,0 +1,173 @@
+#include "CompactValue.h"
+
+#include <atomic>
+#include <cassert>
+
+#include "JObject.h"
+
+namespace jobject {
+
+static_assert(sizeof(void *) == 8,
+              "CompactValue stores pointers in the 48-bit NaN payload");
+
+static_assert(alignof(JObject) >= 8,
+              "CompactValue keeps the object kind in the low pointer bits");
+
+// 装箱值：保存无法直接编码的值，拷贝 CompactValue 时共享并增加引用计数
+struct CompactValue::Box {
+  explicit Box(const ValueVariant &v) : value(v) {}
+
+  std::atomic<uint32_t> refs{1};
+  ValueVariant value;
+};
+
+CompactValue::CompactValue(const ValueVariant &value) {
+  switch (static_cast<ValueType>(value.index())) {
+  case ValueType::Undefined:
+    bits_ = kUndefinedBits;
+    return;
+  case ValueType::Null:
+    bits_ = kNullBits;
+    return;
+  case ValueType::Boolean:
+    bits_ = std::get<bool>(value) ? kTrueBits : kFalseBits;
+    return;
+  case ValueType::Int32:
+    bits_ = kInt32Tag | static_cast<uint32_t>(std::get<int32_t>(value));
+    return;
+  case ValueType::UInt32:
+    bits_ = kUInt32Tag | std::get<uint32_t>(value);
+    return;
+  case ValueType::UInt64:
+    if (std::get<uint64_t>(value) <= kPayloadMask) {
+      bits_ = kUInt64Tag | std::get<uint64_t>(value);
+      return;
+    }
+    break;
+  case ValueType::Double:
+    bits_ = encodeDouble(std::get<double>(value));
+    return;
+  default:
+    break;
+  }
+
+  if (std::holds_alternative<uint64_t>(value)) {
+    bits_ = kBoxTag | reinterpret_cast<uint64_t>(new Box(value));
+    return;
+  }
+
+  const JObject *object = nullptr;
+  switch (static_cast<ValueType>(value.index())) {
+  case ValueType::String:
+    object = std::get<Ref<JString>>(value).get();
+    break;
+  case ValueType::Array:
+    object = std::get<Ref<JArray>>(value).get();
+    break;
+  case ValueType::Function:
+    object = std::get<Ref<JFunction>>(value).get();
+    break;
+  case ValueType::Date:
+    object = std::get<Ref<JDate>>(value).get();
+    break;
+  default:
+    object = std::get<Ref<JObject>>(value).get();
+    break;
+  }
+  if (object) {
+    const auto *counted = static_cast<const RefCounted *>(object);
+    const auto address = reinterpret_cast<uint64_t>(counted);
+    assert((address & (kObjectKindMask | ~kPayloadMask)) == 0);
+    counted->retainRef();
+    bits_ = kObjectTag | address |
+            (value.index() - static_cast<size_t>(ValueType::String));
+    return;
+  }
+  // 空对象引用按 null 保存
+  bits_ = kNullBits;
+}
+
+ValueType CompactValue::type() const {
+  if (isDouble()) {
+    return ValueType::Double;
+  }
+  switch (tagOf(bits_)) {
+  case kInt32Tag:
+    return ValueType::Int32;
+  case kUInt32Tag:
+    return ValueType::UInt32;
+  case kUInt64Tag:
+    return ValueType::UInt64;
+  case kSpecialTag:
+    if (bits_ == kUndefinedBits || bits_ == kHoleBits) {
+      return ValueType::Undefined;
+    }
+    return bits_ == kNullBits ? ValueType::Null : ValueType::Boolean;
+  case kObjectTag:
+    // ValueType 的枚举顺序与 ValueVariant 的备选类型顺序一致
+    return static_cast<ValueType>(static_cast<size_t>(ValueType::String) +
+                                  (bits_ & kObjectKindMask));
+  default:
+    return ValueType::UInt64;
+  }
+}
+
+ValueVariant CompactValue::toVariant() const {
+  if (isDouble()) {
+    return asDouble();
+  }
+  switch (tagOf(bits_)) {
+  case kInt32Tag:
+    return asInt32();
+  case kUInt32Tag:
+    return static_cast<uint32_t>(bits_ & 0xFFFFFFFFu);
+  case kUInt64Tag:
+    return static_cast<uint64_t>(bits_ & kPayloadMask);
+  case kSpecialTag:
+    switch (bits_) {
+    case kNullBits:
+      return nullptr;
+    case kFalseBits:
+      return false;
+    case kTrueBits:
+      return true;
+    default:
+      return JUndefined{};
+    }
+  case kObjectTag: {
+    auto *object =
+        static_cast<JObject *>(const_cast<RefCounted *>(this->object()));
+    switch (type()) {
+    case ValueType::String:
+      return Ref<JString>(static_cast<JString *>(object));
+    case ValueType::Array:
+      return Ref<JArray>(static_cast<JArray *>(object));
+    case ValueType::Function:
+      return Ref<JFunction>(static_cast<JFunction *>(object));
+    case ValueType::Date:
+      return Ref<JDate>(static_cast<JDate *>(object));
+    default:
+      return Ref<JObject>(object);
+    }
+  }
+  default:
+    return box()->value;
+  }
+}
+
+void CompactValue::destroyObject() const {
+  delete static_cast<const JObject *>(object());
+}
+
+void CompactValue::retainBox() const {
+  box()->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CompactValue::releaseBox() const {
+  Box *b = box();
+  if (b->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete b;
+  }
+}
+
+} // namespace jobject
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "Value.h"
+
+namespace jobject {
+
+// 8 字节的紧凑值表示（NaN-boxing），用于数组元素与对象属性槽位的内部存储。
+//
+// 编码：非 NaN 的 double 按原始位模式保存，所有 NaN 规范化为同一个正 NaN；
+// 其余类型放在高 16 位不小于 0xFFF9 的 NaN 空间中：
+//   0xFFF9  int32（低 32 位）
+//   0xFFFA  uint32（低 32 位）
+//   0xFFFB  可用 48 位表示的 uint64
+//   0xFFFC  undefined / null / false / true，以及数组内部的空位（hole）
+//   0xFFFD  指向引用计数装箱值的指针（超出 48 位的 uint64）
+//   0xFFFE  对象引用：直接保存对象的引用计数基址，低 3 位记录 ValueVariant
+//           中的备选类型（String/Array/Object/Function/Date）
+// 数值与特殊值不占用堆内存；对象引用拷贝时只增加对象自身的侵入式计数。
+// 与 ValueVariant 的转换发生在 API 边界上。
+class CompactValue {
+public:
+  CompactValue() : bits_(kUndefinedBits) {}
+  CompactValue(const ValueVariant &value);
+
+  static CompactValue fromInt32(int32_t value) {
+    return CompactValue(kInt32Tag | static_cast<uint32_t>(value), RawBits{});
+  }
+  static CompactValue fromDouble(double value) {
+    return CompactValue(encodeDouble(value), RawBits{});
+  }
+  // 数组空位：只出现在元素存储内部，读取时表现为 undefined，
+  // 但不算作存在的元素。ValueVariant 转换永远不会得到空位
+  static CompactValue hole() { return CompactValue(kHoleBits, RawBits{}); }
+
+  CompactValue(const CompactValue &other) : bits_(other.bits_) {
+    if (isObject()) {
+      object()->retainRef();
+    } else if (isBoxed()) {
+      retainBox();
+    }
+  }
+  CompactValue(CompactValue &&other) noexcept : bits_(other.bits_) {
+    other.bits_ = kUndefinedBits;
+  }
+  CompactValue &operator=(const CompactValue &other) {
+    CompactValue copy(other);
+    swap(copy);
+    return *this;
+  }
+  CompactValue &operator=(CompactValue &&other) noexcept {
+    CompactValue moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+  ~CompactValue() {
+    if (isObject()) {
+      if (object()->releaseRef()) {
+        destroyObject();
+      }
+    } else if (isBoxed()) {
+      releaseBox();
+    }
+  }
+
+  void swap(CompactValue &other) noexcept {
+    const uint64_t bits = bits_;
+    bits_ = other.bits_;
+    other.bits_ = bits;
+  }
+
+  ValueType type() const;
+  ValueVariant toVariant() const;
+
+  bool isUndefined() const { return bits_ == kUndefinedBits; }
+  bool isHole() const { return bits_ == kHoleBits; }
+  bool isInt32() const { return tagOf(bits_) == kInt32Tag; }
+  bool isDouble() const { return bits_ < kMinTag; }
+  int32_t asInt32() const { return static_cast<int32_t>(bits_ & 0xFFFFFFFFu); }
+  double asDouble() const {
+    double value;
+    std::memcpy(&value, &bits_, sizeof(value));
+    return value;
+  }
+
+private:
+  struct Box;
+
+  struct RawBits {};
+  CompactValue(uint64_t bits, RawBits) : bits_(bits) {}
+
+  static constexpr uint64_t kTagMask = 0xFFFFull << 48;
+  static constexpr uint64_t kPayloadMask = (1ull << 48) - 1;
+  static constexpr uint64_t kMinTag = 0xFFF9ull << 48;
+  static constexpr uint64_t kInt32Tag = 0xFFF9ull << 48;
+  static constexpr uint64_t kUInt32Tag = 0xFFFAull << 48;
+  static constexpr uint64_t kUInt64Tag = 0xFFFBull << 48;
+  static constexpr uint64_t kSpecialTag = 0xFFFCull << 48;
+  static constexpr uint64_t kBoxTag = 0xFFFDull << 48;
+  static constexpr uint64_t kObjectTag = 0xFFFEull << 48;
+  static constexpr uint64_t kObjectKindMask = 7;
+
+  static constexpr uint64_t kUndefinedBits = kSpecialTag | 0;
+  static constexpr uint64_t kNullBits = kSpecialTag | 1;
+  static constexpr uint64_t kFalseBits = kSpecialTag | 2;
+  static constexpr uint64_t kTrueBits = kSpecialTag | 3;
+  static constexpr uint64_t kHoleBits = kSpecialTag | 4;
+  static constexpr uint64_t kCanonicalNaN = 0x7FF8000000000000ull;
+
+  static uint64_t tagOf(uint64_t bits) { return bits & kTagMask; }
+
+  static uint64_t encodeDouble(double value) {
+    if (value != value) {
+      return kCanonicalNaN;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  bool isBoxed() const { return tagOf(bits_) == kBoxTag; }
+  Box *box() const { return reinterpret_cast<Box *>(bits_ & kPayloadMask); }
+  void retainBox() const;
+  void releaseBox() const;
+
+  bool isObject() const { return tagOf(bits_) == kObjectTag; }
+  const RefCounted *object() const {
+    return reinterpret_cast<const RefCounted *>(bits_ & kPayloadMask &
+                                                ~kObjectKindMask);
+  }
+  void destroyObject() const;
+
+  uint64_t bits_;
+};
+
+static_assert(sizeof(CompactValue) == 8, "CompactValue must stay 8 bytes");
+
+} // namespace jobject
@@ -0,0 +1,135 @@
+#include "Dictionary.h"
+
+#include <algorithm>
+
+// 析构 PropertySlot 中的对象引用需要完整的对象类型
+#include "JObject.h"
+
+namespace jobject {
+
+namespace {
+
+// 索引表最多装填 2/3，返回容纳 count 个条目所需的 2 的幂容量
+size_t indexCapacityFor(size_t count) {
+  size_t capacity = 8;
+  while (capacity * 2 / 3 < count) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+} // namespace
+
+void PropertyDictionary::reserve(size_t count) {
+  const size_t total = entries_.size() + count;
+  if (index_.size() * 2 / 3 < total) {
+    rebuild(size() + count);
+  }
+  entries_.reserve(entries_.size() + count);
+}
+
+size_t PropertyDictionary::lookupIndex(std::string_view name,
+                                       size_t hash) const {
+  if (index_.empty()) {
+    return SIZE_MAX;
+  }
+  const size_t mask = index_.size() - 1;
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    const uint32_t ix = index_[pos];
+    if (ix == kEmpty) {
+      return SIZE_MAX;
+    }
+    if (ix != kDummy && entries_[ix].hash == hash &&
+        entries_[ix].name == name) {
+      return pos;
+    }
+  }
+}
+
+PropertySlot *PropertyDictionary::find(std::string_view name, size_t hash) {
+  const size_t pos = lookupIndex(name, hash);
+  return pos == SIZE_MAX ? nullptr : &entries_[index_[pos]].slot;
+}
+
+const PropertySlot *PropertyDictionary::find(std::string_view name,
+                                             size_t hash) const {
+  const size_t pos = lookupIndex(name, hash);
+  return pos == SIZE_MAX ? nullptr : &entries_[index_[pos]].slot;
+}
+
+PropertySlot &PropertyDictionary::insert(std::string name, size_t hash,
+                                         PropertySlot slot) {
+  if ((usedIndexSlots_ + 1) > index_.size() * 2 / 3) {
+    // 装满时按存活条目数的两倍重建，墓碑同时被清除
+    rebuild(std::max<size_t>(size() * 2, size() + 1));
+  }
+  const size_t mask = index_.size() - 1;
+  size_t pos = hash & mask;
+  while (index_[pos] != kEmpty) {
+    pos = (pos + 1) & mask;
+  }
+  index_[pos] = static_cast<uint32_t>(entries_.size());
+  ++usedIndexSlots_;
+  entries_.push_back(Entry{std::move(name), hash, std::move(slot), true});
+  return entries_.back().slot;
+}
+
+bool PropertyDictionary::erase(std::string_view name) {
+  const size_t pos = lookupIndex(name, hashPropertyName(name));
+  if (pos == SIZE_MAX) {
+    return false;
+  }
+  const uint32_t ix = index_[pos];
+  if (!entries_[ix].slot.configurable()) {
+    return false;
+  }
+  index_[pos] = kDummy;
+
+  if (ix + 1 == entries_.size()) {
+    // 删除最后插入的条目无需留下墓碑
+    entries_.pop_back();
+  } else {
+    Entry &entry = entries_[ix];
+    entry.live = false;
+    std::string().swap(entry.name);
+    entry.slot = PropertySlot();
+    ++deleted_;
+  }
+
+  if (size() == 0) {
+    entries_.clear();
+    std::fill(index_.begin(), index_.end(), kEmpty);
+    usedIndexSlots_ = 0;
+    deleted_ = 0;
+  } else if (deleted_ >= 8 && deleted_ * 2 > entries_.size()) {
+    // 墓碑超过一半时压缩，保证枚举与内存开销与存活属性数成正比
+    rebuild(size());
+  }
+  return true;
+}
+
+void PropertyDictionary::rebuild(size_t minCount) {
+  if (deleted_ > 0) {
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [](const Entry &entry) {
+                                    return !entry.live;
+                                  }),
+                   entries_.end());
+    deleted_ = 0;
+  }
+
+  const size_t capacity =
+      indexCapacityFor(std::max(minCount, entries_.size()));
+  index_.assign(capacity, kEmpty);
+  const size_t mask = capacity - 1;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    size_t pos = entries_[i].hash & mask;
+    while (index_[pos] != kEmpty) {
+      pos = (pos + 1) & mask;
+    }
+    index_[pos] = static_cast<uint32_t>(i);
+  }
+  usedIndexSlots_ = entries_.size();
+}
+
+} // namespace jobject
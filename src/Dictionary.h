@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Atom.h"
+#include "Property.h"
+
+namespace jobject {
+
+// 字典模式对象的属性存储：紧凑有序字典（与 CPython dict 相同的布局）。
+//
+// 条目按插入顺序追加到稠密的 entries_ 数组中，属性名只保存一份；
+// 另有一张只存条目下标的小型开放寻址索引表 index_ 负责按名查找。
+// 枚举直接顺序扫描 entries_，天然保持插入顺序且无需再次哈希。
+// 删除只把条目标记为墓碑并在索引中留下占位，复杂度 O(1)；
+// 墓碑过多或索引装满时整体压缩并重建索引。
+class PropertyDictionary {
+public:
+  size_t size() const { return entries_.size() - deleted_; }
+  bool empty() const { return size() == 0; }
+
+  // 预留 count 个属性的空间，之后插入 count 个属性不再重建索引
+  void reserve(size_t count);
+
+  // hash 必须等于 hashPropertyName(name)（原子的预计算哈希即满足）
+  PropertySlot *find(std::string_view name, size_t hash);
+  const PropertySlot *find(std::string_view name, size_t hash) const;
+  PropertySlot *find(std::string_view name) {
+    return find(name, hashPropertyName(name));
+  }
+  const PropertySlot *find(std::string_view name) const {
+    return find(name, hashPropertyName(name));
+  }
+
+  // 插入新属性，调用方保证 name 尚不存在
+  PropertySlot &insert(std::string name, size_t hash, PropertySlot slot);
+  PropertySlot &insert(std::string name, PropertySlot slot) {
+    const size_t hash = hashPropertyName(name);
+    return insert(std::move(name), hash, std::move(slot));
+  }
+
+  // 删除属性；不存在或不可配置时返回 false
+  bool erase(std::string_view name);
+
+  // 按插入顺序访问全部属性：visitor(const std::string &, const PropertySlot &)
+  template <typename Visitor> void forEach(Visitor &&visitor) const {
+    for (const auto &entry : entries_) {
+      if (entry.live) {
+        visitor(entry.name, entry.slot);
+      }
+    }
+  }
+
+private:
+  struct Entry {
+    std::string name;
+    size_t hash = 0;
+    PropertySlot slot;
+    bool live = true;
+  };
+
+  static constexpr uint32_t kEmpty = UINT32_MAX;
+  static constexpr uint32_t kDummy = UINT32_MAX - 1; // 已删除条目的占位
+
+  // 返回 name 在 index_ 中的位置，不存在时返回 SIZE_MAX
+  size_t lookupIndex(std::string_view name, size_t hash) const;
+  // 丢弃墓碑并按容纳 minCount 个条目的大小重建索引
+  void rebuild(size_t minCount);
+
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> index_;
+  size_t deleted_ = 0;
+  size_t usedIndexSlots_ = 0; // 非空索引位（含占位）的数量
+};
+
+} // namespace jobject
@@ -0,0 +1,773 @@
+#include "Elements.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ChunkedList.h"
+
+// 析构 ValueVariant 需要完整的对象类型
+#include "JObject.h"
+
+namespace jobject {
+
+struct SparseElements {
+  std::map<size_t, CompactValue> values;
+};
+
+// 连续存储缓冲区的头部，位于第一个元素槽位之前。slice 得到的视图与原数组
+// 共享缓冲区，refs 为共享者个数，任何一方写入前先复制出独占的缓冲区。
+// slice 是 const 操作，多个线程可能同时从同一个数组切片，头部字段都是原子的
+struct ElementsBuffer {
+  std::atomic<uint32_t> refs{1};
+  // 开始共享时缓冲区中已构造元素的槽位范围；共享期间没有人写入，
+  // 最后释放缓冲区的视图据此析构元素。由第一次切片写入（并发切片写入的
+  // 是相同的值），随 refs 的递增发布，读取前对 refs 的 acquire 操作与之同步
+  std::atomic<uint32_t> liveBegin{0};
+  std::atomic<uint32_t> liveEnd{0};
+};
+
+namespace {
+
+constexpr size_t kBufferHeader = 16;
+static_assert(sizeof(ElementsBuffer) <= kBufferHeader &&
+                  kBufferHeader % alignof(uint64_t) == 0,
+              "elements must stay 8-byte aligned after the buffer header");
+
+// 分配容纳 slots 个元素的缓冲区，返回第一个槽位的地址
+char *allocateSlots(size_t slots, size_t bytes) {
+  auto *base =
+      static_cast<char *>(std::malloc(kBufferHeader + slots * bytes));
+  if (!base) {
+    throw std::bad_alloc();
+  }
+  new (base) ElementsBuffer();
+  return base + kBufferHeader;
+}
+
+} // namespace
+
+ElementsBuffer *Elements::buffer() const {
+  return reinterpret_cast<ElementsBuffer *>(static_cast<char *>(allocation()) -
+                                            kBufferHeader);
+}
+
+Elements::Elements(size_t size) { resize(size); }
+
+Elements::Elements(const ValueVariant *values, size_t count) {
+  insert(0, values, count);
+}
+
+Elements::Elements(const Elements &other)
+    : Elements(other.slice(0, other.size_)) {}
+
+Elements::Elements(Elements &&other) noexcept
+    : data_(other.data_), size_(other.size_), capacity_(other.capacity_),
+      front_(other.front_), kind_(other.kind_), view_(other.view_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.capacity_ = 0;
+  other.front_ = 0;
+  other.kind_ = ElementsKind::Empty;
+  other.view_ = false;
+}
+
+Elements &Elements::operator=(const Elements &other) {
+  if (this != &other) {
+    *this = other.slice(0, other.size_);
+  }
+  return *this;
+}
+
+Elements &Elements::operator=(Elements &&other) noexcept {
+  if (this != &other) {
+    clear();
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(front_, other.front_);
+    std::swap(kind_, other.kind_);
+    std::swap(view_, other.view_);
+  }
+  return *this;
+}
+
+Elements::~Elements() { clear(); }
+
+ElementsKind Elements::kindFor(const ValueVariant &value) {
+  switch (static_cast<ValueType>(value.index())) {
+  case ValueType::Int32:
+    return ElementsKind::Int32;
+  case ValueType::Double:
+    return ElementsKind::Double;
+  case ValueType::UInt64:
+    return ElementsKind::UInt64;
+  default:
+    return ElementsKind::Generic;
+  }
+}
+
+size_t Elements::count() const {
+  switch (kind_) {
+  case ElementsKind::Sparse:
+    return sparse()->values.size();
+  case ElementsKind::Generic:
+    return static_cast<size_t>(
+        std::count_if(generic(), generic() + size_,
+                      [](const CompactValue &value) { return !value.isHole(); }));
+  case ElementsKind::Chunked: {
+    size_t present = 0;
+    chunked()->forEach(0, size_, [&present](const CompactValue &value) {
+      present += !value.isHole();
+    });
+    return present;
+  }
+  default:
+    return size_;
+  }
+}
+
+bool Elements::has(size_t index) const {
+  if (index >= size_) {
+    return false;
+  }
+  switch (kind_) {
+  case ElementsKind::Sparse:
+    return sparse()->values.count(index) != 0;
+  case ElementsKind::Generic:
+    return !generic()[index].isHole();
+  case ElementsKind::Chunked:
+    return !chunked()->at(index).isHole();
+  default:
+    return true;
+  }
+}
+
+size_t Elements::nextIndex(size_t from) const {
+  switch (kind_) {
+  case ElementsKind::Sparse: {
+    const auto it = sparse()->values.lower_bound(from);
+    return it == sparse()->values.end() ? size_ : it->first;
+  }
+  case ElementsKind::Generic:
+  case ElementsKind::Chunked:
+    while (from < size_ && !has(from)) {
+      ++from;
+    }
+    return std::min(from, size_);
+  default:
+    return std::min(from, size_);
+  }
+}
+
+ValueVariant Elements::get(size_t index) const {
+  switch (kind_) {
+  case ElementsKind::Int32:
+    return static_cast<const int32_t *>(data_)[index];
+  case ElementsKind::Double:
+    return static_cast<const double *>(data_)[index];
+  case ElementsKind::UInt64:
+    return static_cast<const uint64_t *>(data_)[index];
+  case ElementsKind::Generic:
+    return generic()[index].toVariant();
+  case ElementsKind::Sparse: {
+    const auto it = sparse()->values.find(index);
+    return it == sparse()->values.end() ? ValueVariant{JUndefined{}}
+                                        : it->second.toVariant();
+  }
+  case ElementsKind::Chunked:
+    return chunked()->at(index).toVariant();
+  default:
+    return JUndefined{};
+  }
+}
+
+void Elements::set(size_t index, const ValueVariant &value) {
+  prepareWrite();
+  if (kind_ == ElementsKind::Sparse) {
+    sparse()->values[index] = CompactValue(value);
+    densifyIfFull();
+    return;
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    chunked()->at(index) = CompactValue(value);
+    return;
+  }
+  prepareFor(kindFor(value));
+  if (kind_ == ElementsKind::Generic) {
+    generic()[index] = CompactValue(value);
+  } else {
+    store(index, value);
+  }
+}
+
+void Elements::put(size_t index, const ValueVariant &value) {
+  if (index < size_) {
+    set(index, value);
+    return;
+  }
+  if (index > size_) {
+    checkGrowth(index - size_);
+    prepareWrite();
+    grow(index, false);
+  }
+  push(value);
+}
+
+void Elements::push(const ValueVariant &value) {
+  checkGrowth(1);
+  prepareWrite();
+  if (kind_ == ElementsKind::Sparse) {
+    sparse()->values.emplace_hint(sparse()->values.end(), size_,
+                                  CompactValue(value));
+    ++size_;
+    densifyIfFull();
+    return;
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    chunked()->insert(size_, CompactValue(value));
+    ++size_;
+    return;
+  }
+  prepareFor(kindFor(value));
+  reserve(size_ + 1);
+  store(size_, value);
+  ++size_;
+}
+
+ValueVariant Elements::pop() {
+  prepareWrite();
+  if (kind_ == ElementsKind::Sparse) {
+    ValueVariant result = get(size_ - 1);
+    sparse()->values.erase(size_ - 1);
+    --size_;
+    densifyIfFull();
+    return result;
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    ValueVariant result = get(size_ - 1);
+    erase(size_ - 1, 1);
+    return result;
+  }
+  ValueVariant result = get(size_ - 1);
+  destroyRange(size_ - 1, size_);
+  --size_;
+  return result;
+}
+
+void Elements::insert(size_t pos, const ValueVariant *values, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  checkGrowth(count);
+  prepareWrite();
+  if (kind_ == ElementsKind::Sparse) {
+    // 其后的元素整体后移：从大到小依次改键，移动后的键都大于剩余的键，
+    // 可直接在末尾插回
+    auto &map = sparse()->values;
+    std::vector<std::map<size_t, CompactValue>::node_type> moved;
+    for (auto it = map.lower_bound(pos); it != map.end();) {
+      moved.push_back(map.extract(it++));
+    }
+    for (auto &node : moved) {
+      node.key() += count;
+      map.insert(map.end(), std::move(node));
+    }
+    for (size_t i = 0; i < count; ++i) {
+      map.emplace(pos + i, CompactValue(values[i]));
+    }
+    size_ += count;
+    densifyIfFull();
+    return;
+  }
+  if (kind_ != ElementsKind::Chunked &&
+      shouldChunk(std::min(pos, size_ - pos))) {
+    convertToChunked();
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    for (size_t i = 0; i < count; ++i) {
+      chunked()->insert(pos + i, CompactValue(values[i]));
+    }
+    size_ += count;
+    return;
+  }
+  // 插入的值与当前种类全部一致时保持紧密存储，否则转为 Generic
+  ElementsKind kind =
+      kind_ == ElementsKind::Empty ? kindFor(values[0]) : kind_;
+  for (size_t i = 0; i < count && kind != ElementsKind::Generic; ++i) {
+    if (kindFor(values[i]) != kind) {
+      kind = ElementsKind::Generic;
+    }
+  }
+  prepareFor(kind);
+
+  // 移动插入点两侧中较短的一侧：头部插入只需把起点前移
+  const size_t bytes = elementBytes(kind_);
+  if (pos < size_ - pos) {
+    reserveFront(count);
+    data_ = static_cast<char *>(data_) - count * bytes;
+    front_ -= count;
+    capacity_ += count;
+    auto *base = static_cast<char *>(data_);
+    std::memmove(base, base + count * bytes, pos * bytes);
+  } else {
+    reserve(size_ + count);
+    auto *base = static_cast<char *>(data_);
+    std::memmove(base + (pos + count) * bytes, base + pos * bytes,
+                 (size_ - pos) * bytes);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    store(pos + i, values[i]);
+  }
+  size_ += count;
+}
+
+void Elements::erase(size_t pos, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  prepareWrite();
+  if (kind_ == ElementsKind::Sparse) {
+    auto &map = sparse()->values;
+    auto it = map.erase(map.lower_bound(pos), map.lower_bound(pos + count));
+    while (it != map.end()) {
+      auto node = map.extract(it++);
+      node.key() -= count;
+      map.insert(it, std::move(node));
+    }
+    size_ -= count;
+    densifyIfFull();
+    return;
+  }
+  if (kind_ != ElementsKind::Chunked &&
+      shouldChunk(std::min(pos, size_ - pos - count))) {
+    convertToChunked();
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    chunked()->erase(pos, count);
+    size_ -= count;
+    if (size_ < kMinChunkedSize / 4) {
+      // 缩小后回到连续存储
+      convertToPacked();
+    }
+    return;
+  }
+  destroyRange(pos, pos + count);
+  const size_t bytes = elementBytes(kind_);
+  auto *base = static_cast<char *>(data_);
+  if (pos < size_ - pos - count) {
+    // 前段较短时前段后移并推进起点，头部删除为 O(1)
+    std::memmove(base + count * bytes, base, pos * bytes);
+    data_ = base + count * bytes;
+    front_ += count;
+    capacity_ -= count;
+  } else {
+    std::memmove(base + pos * bytes, base + (pos + count) * bytes,
+                 (size_ - pos - count) * bytes);
+  }
+  size_ -= count;
+  if (size_ == 0 && front_ > 0) {
+    data_ = allocation();
+    capacity_ += front_;
+    front_ = 0;
+  }
+}
+
+void Elements::resize(size_t size) {
+  if (size > size_) {
+    checkGrowth(size - size_);
+  }
+  prepareWrite();
+  if (kind_ == ElementsKind::Sparse) {
+    if (size < size_) {
+      auto &map = sparse()->values;
+      map.erase(map.lower_bound(size), map.end());
+    }
+    size_ = size;
+    densifyIfFull();
+    return;
+  }
+  if (size > size_) {
+    grow(size, true);
+    return;
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    erase(size, size_ - size);
+    return;
+  }
+  destroyRange(size, size_);
+  size_ = size;
+}
+
+void Elements::grow(size_t size, bool preallocate) {
+  if (kind_ == ElementsKind::Sparse) {
+    size_ = size;
+    return;
+  }
+  if (size - size_ > kMinSparseHoles && size_ < size / 4 &&
+      (!preallocate || size > kMaxPreallocatedSize)) {
+    // 补齐的空位远多于现有元素，改为只记录长度
+    convertToSparse();
+    size_ = size;
+    return;
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    while (size_ < size) {
+      chunked()->insert(size_, CompactValue::hole());
+      ++size_;
+    }
+    return;
+  }
+  // 紧密存储无法表示空位，扩展长度会转为 Generic
+  prepareFor(ElementsKind::Generic);
+  reserve(size);
+  for (size_t i = size_; i < size; ++i) {
+    new (generic() + i) CompactValue(CompactValue::hole());
+  }
+  size_ = size;
+}
+
+void Elements::clear() {
+  if (kind_ == ElementsKind::Sparse || kind_ == ElementsKind::Chunked) {
+    if (kind_ == ElementsKind::Sparse) {
+      delete sparse();
+    } else {
+      delete chunked();
+    }
+    data_ = nullptr;
+    size_ = 0;
+    kind_ = ElementsKind::Empty;
+    return;
+  }
+  if (data_) {
+    ElementsBuffer *shared = buffer();
+    // 只有自己持有时不必原子递减：其他人无从得到这个缓冲区
+    if (shared->refs.load(std::memory_order_acquire) == 1 ||
+        shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (!view_) {
+        destroyRange(0, size_);
+      } else if (kind_ == ElementsKind::Generic) {
+        auto *slots = static_cast<CompactValue *>(allocation());
+        const size_t end = shared->liveEnd.load(std::memory_order_relaxed);
+        for (size_t i = shared->liveBegin.load(std::memory_order_relaxed);
+             i < end; ++i) {
+          slots[i].~CompactValue();
+        }
+      }
+      shared->~ElementsBuffer();
+      std::free(shared);
+    }
+  }
+  data_ = nullptr;
+  size_ = 0;
+  capacity_ = 0;
+  front_ = 0;
+  kind_ = ElementsKind::Empty;
+  view_ = false;
+}
+
+Elements Elements::slice(size_t begin, size_t end) const {
+  const size_t count = end > begin ? end - begin : 0;
+  if (count < kMinSharedSlice || !data_ || kind_ == ElementsKind::Sparse ||
+      kind_ == ElementsKind::Chunked || front_ + size_ > UINT32_MAX) {
+    return copy(begin, end);
+  }
+  ElementsBuffer *shared = buffer();
+  if (!view_ && shared->refs.load(std::memory_order_acquire) == 1) {
+    shared->liveBegin.store(static_cast<uint32_t>(front_),
+                            std::memory_order_relaxed);
+    shared->liveEnd.store(static_cast<uint32_t>(front_ + size_),
+                          std::memory_order_relaxed);
+  }
+  shared->refs.fetch_add(1, std::memory_order_release);
+
+  Elements result;
+  result.data_ = static_cast<char *>(data_) + begin * elementBytes(kind_);
+  result.size_ = count;
+  result.capacity_ = count;
+  result.front_ = front_ + begin;
+  result.kind_ = kind_;
+  result.view_ = true;
+  return result;
+}
+
+Elements Elements::copy(size_t begin, size_t end) const {
+  Elements result;
+  if (begin >= end) {
+    return result;
+  }
+  const size_t count = end - begin;
+  if (kind_ == ElementsKind::Sparse) {
+    result.convertToSparse();
+    auto &map = sparse()->values;
+    for (auto it = map.lower_bound(begin); it != map.end() && it->first < end;
+         ++it) {
+      result.sparse()->values.emplace_hint(result.sparse()->values.end(),
+                                           it->first - begin, it->second);
+    }
+    result.size_ = count;
+    result.densifyIfFull();
+    return result;
+  }
+  if (kind_ == ElementsKind::Chunked) {
+    // 切片结果较小，按连续存储重新建立
+    result.appendChunked(*chunked(), begin, end);
+    return result;
+  }
+  result.kind_ = kind_;
+  result.reserve(count);
+  if (kind_ == ElementsKind::Generic) {
+    for (size_t i = 0; i < count; ++i) {
+      new (result.generic() + i) CompactValue(generic()[begin + i]);
+    }
+  } else {
+    const size_t bytes = elementBytes(kind_);
+    std::memcpy(result.data_, static_cast<const char *>(data_) + begin * bytes,
+                count * bytes);
+  }
+  result.size_ = count;
+  return result;
+}
+
+void Elements::prepareFor(ElementsKind kind) {
+  if (kind_ == kind || kind_ == ElementsKind::Generic) {
+    return;
+  }
+  if (kind_ == ElementsKind::Empty) {
+    kind_ = kind;
+    return;
+  }
+  convertToGeneric();
+}
+
+void Elements::convertToGeneric() {
+  CompactValue *converted = nullptr;
+  if (capacity_ > 0) {
+    converted = reinterpret_cast<CompactValue *>(
+        allocateSlots(capacity_, sizeof(CompactValue)));
+  }
+  for (size_t i = 0; i < size_; ++i) {
+    switch (kind_) {
+    case ElementsKind::Int32:
+      new (converted + i) CompactValue(
+          CompactValue::fromInt32(static_cast<int32_t *>(data_)[i]));
+      break;
+    case ElementsKind::Double:
+      new (converted + i) CompactValue(
+          CompactValue::fromDouble(static_cast<double *>(data_)[i]));
+      break;
+    default:
+      new (converted + i)
+          CompactValue(ValueVariant(static_cast<uint64_t *>(data_)[i]));
+      break;
+    }
+  }
+  if (data_) {
+    std::free(buffer());
+  }
+  data_ = converted;
+  front_ = 0;
+  kind_ = ElementsKind::Generic;
+}
+
+void Elements::convertToSparse() {
+  auto *converted = new SparseElements();
+  if (kind_ == ElementsKind::Chunked) {
+    size_t index = 0;
+    chunked()->forEach(0, size_, [&](const CompactValue &value) {
+      if (!value.isHole()) {
+        converted->values.emplace_hint(converted->values.end(), index, value);
+      }
+      ++index;
+    });
+  } else {
+    for (size_t i = 0; i < size_; ++i) {
+      if (has(i)) {
+        converted->values.emplace_hint(converted->values.end(), i,
+                                       CompactValue(get(i)));
+      }
+    }
+  }
+  const size_t size = size_;
+  clear();
+  data_ = converted;
+  size_ = size;
+  kind_ = ElementsKind::Sparse;
+}
+
+void Elements::prepareWrite() {
+  if (!data_ || kind_ == ElementsKind::Sparse ||
+      kind_ == ElementsKind::Chunked) {
+    return;
+  }
+  ElementsBuffer *shared = buffer();
+  if (shared->refs.load(std::memory_order_acquire) != 1) {
+    // 仍有其他共享者，复制出自己的部分
+    *this = copy(0, size_);
+    return;
+  }
+  if (view_) {
+    // 其他共享者都已释放，视图接管整个缓冲区并析构视图之外的元素
+    if (kind_ == ElementsKind::Generic) {
+      auto *slots = static_cast<CompactValue *>(allocation());
+      for (size_t i = shared->liveBegin.load(std::memory_order_relaxed);
+           i < front_; ++i) {
+        slots[i].~CompactValue();
+      }
+      const size_t end = shared->liveEnd.load(std::memory_order_relaxed);
+      for (size_t i = front_ + size_; i < end; ++i) {
+        slots[i].~CompactValue();
+      }
+    }
+    capacity_ = size_;
+    view_ = false;
+  }
+}
+
+void Elements::checkGrowth(size_t added) const {
+  if (added > kMaxSize - size_) {
+    throw std::length_error("array length exceeds 2^32 - 1");
+  }
+}
+
+bool Elements::shouldChunk(size_t moved) const {
+  return size_ >= kMinChunkedSize && moved >= kMinChunkedMove;
+}
+
+void Elements::convertToChunked() {
+  auto *converted = new ChunkedList();
+  for (size_t i = 0; i < size_; ++i) {
+    // 通用存储按位复制，保留空位
+    converted->insert(i, kind_ == ElementsKind::Generic ? generic()[i]
+                                                        : CompactValue(get(i)));
+  }
+  const size_t size = size_;
+  clear();
+  data_ = converted;
+  size_ = size;
+  kind_ = ElementsKind::Chunked;
+}
+
+void Elements::convertToPacked() {
+  Elements packed;
+  packed.appendChunked(*chunked(), 0, size_);
+  *this = std::move(packed);
+}
+
+void Elements::appendChunked(const ChunkedList &list, size_t begin,
+                             size_t end) {
+  bool holes = false;
+  list.forEach(begin, end, [&holes](const CompactValue &value) {
+    holes = holes || value.isHole();
+  });
+  reserve(size_ + (end - begin));
+  if (!holes) {
+    // 逐个追加，同构的数值元素重新得到紧密存储
+    list.forEach(begin, end,
+                 [this](const CompactValue &value) { push(value.toVariant()); });
+    return;
+  }
+  prepareFor(ElementsKind::Generic);
+  list.forEach(begin, end, [this](const CompactValue &value) {
+    new (generic() + size_) CompactValue(value);
+    ++size_;
+  });
+}
+
+void Elements::densifyIfFull() {
+  if (sparse()->values.size() != size_) {
+    return;
+  }
+  // 逐个追加，同构的数值元素重新得到紧密存储
+  Elements dense;
+  dense.reserve(size_);
+  for (const auto &entry : sparse()->values) {
+    dense.push(entry.second.toVariant());
+  }
+  *this = std::move(dense);
+}
+
+void Elements::reserve(size_t capacity) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  const size_t bytes = elementBytes(kind_);
+  if (front_ >= size_ && front_ + capacity_ >= capacity) {
+    // 头部空出的槽位不少于现有元素时搬回开头复用，搬移开销由此前的
+    // 头部删除分摊（队列先进先出时不再增长）
+    void *base = allocation();
+    std::memmove(base, data_, size_ * bytes);
+    data_ = base;
+    capacity_ += front_;
+    front_ = 0;
+    return;
+  }
+  const size_t grown =
+      std::max<size_t>(capacity, std::max<size_t>(capacity_ * 2, 4));
+  if (!data_) {
+    data_ = allocateSlots(grown, bytes);
+    capacity_ = grown;
+    return;
+  }
+  auto *base = static_cast<char *>(
+      std::realloc(buffer(), kBufferHeader + (front_ + grown) * bytes));
+  if (!base) {
+    throw std::bad_alloc();
+  }
+  data_ = base + kBufferHeader + front_ * bytes;
+  capacity_ = grown;
+}
+
+void Elements::reserveFront(size_t count) {
+  if (front_ >= count) {
+    return;
+  }
+  // 头部空间按现有元素数预留，连续的头部插入均摊 O(1)
+  const size_t bytes = elementBytes(kind_);
+  const size_t front = std::max<size_t>(count, std::max<size_t>(size_, 4));
+  const size_t capacity = std::max(capacity_, size_);
+  char *base = allocateSlots(front + capacity, bytes);
+  if (size_ > 0) {
+    std::memcpy(base + front * bytes, data_, size_ * bytes);
+  }
+  if (data_) {
+    std::free(buffer());
+  }
+  data_ = base + front * bytes;
+  capacity_ = capacity;
+  front_ = front;
+}
+
+void Elements::destroyRange(size_t begin, size_t end) {
+  if (kind_ != ElementsKind::Generic) {
+    return;
+  }
+  for (size_t i = begin; i < end; ++i) {
+    generic()[i].~CompactValue();
+  }
+}
+
+void Elements::store(size_t index, const ValueVariant &value) {
+  switch (kind_) {
+  case ElementsKind::Int32:
+    static_cast<int32_t *>(data_)[index] = std::get<int32_t>(value);
+    break;
+  case ElementsKind::Double:
+    static_cast<double *>(data_)[index] = std::get<double>(value);
+    break;
+  case ElementsKind::UInt64:
+    static_cast<uint64_t *>(data_)[index] = std::get<uint64_t>(value);
+    break;
+  default:
+    new (generic() + index) CompactValue(value);
+    break;
+  }
+}
+
+} // namespace jobject
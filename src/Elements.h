@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "CompactValue.h"
+#include "Value.h"
+
+namespace jobject {
+
+// 数组元素种类。内容同构时元素以原始数值紧密保存，写入其他类型的值后
+// 整体转为 Generic（CompactValue）存储，转换只向 Generic 单向进行。
+// 每种种类只保存与之完全相同的 ValueVariant 类型（例如 uint32 不会进入
+// Int32 存储），读取时得到的值类型与写入时一致。
+enum class ElementsKind : uint8_t {
+  Empty,   // 尚未写入元素，由第一个元素决定种类
+  Int32,   // int32_t，每个元素 4 字节
+  Double,  // double，每个元素 8 字节
+  UInt64,  // uint64_t，每个元素 8 字节
+  Generic, // CompactValue，每个元素 8 字节
+  Sparse,  // 稀疏：只保存存在的元素，按下标有序
+  Chunked, // 大数组分块保存（ChunkedList），中间插入删除为 O(log n)
+};
+
+struct SparseElements;
+struct ElementsBuffer;
+class ChunkedList;
+
+// JArray 的元素存储：单块连续缓冲区加元素种类。
+// 所有种类的元素都可按字节搬移（CompactValue 只保存位模式），
+// 扩容与中间插入删除直接使用 realloc/memmove。插入删除时移动较短的一侧，
+// 缓冲区起点之前可以留有空闲槽位，头部删除与插入（shift/unshift）均摊 O(1)。
+//
+// 扩展长度（resize、越过末尾写入）留下的下标都是空位，读取为 undefined，
+// 但 has()/nextIndex() 不把它们算作存在的元素。空位不多时留在连续存储中：
+// 紧密存储无法表示空位，转为 Generic，以 CompactValue::hole() 占位。
+// 越过末尾写入留下超过 kMinSparseHoles 个空位且已有的元素不足新长度的
+// 四分之一时转为 Sparse 种类：只保存存在的元素，长度与元素个数无关；
+// resize 指定的长度不超过 kMaxPreallocatedSize 时总是预留连续的空位，
+// 以便随后按下标逐个填入。稀疏存储的空位全部被填满后自动回到连续存储。
+// 长度不超过 kMaxSize，超出时抛出 std::length_error。
+//
+// 不少于 kMinChunkedSize 个元素的数组在中间插入删除、需要搬移的一侧
+// 不少于 kMinChunkedMove 个元素时转为 Chunked 种类，之后的 splice
+// 不再整体搬移；元素数降到 kMinChunkedSize 的四分之一以下时回到连续存储。
+//
+// 连续存储的缓冲区带有引用计数：不少于 kMinSharedSlice 个元素的 slice
+// 不复制元素，而是成为共享原缓冲区的视图。视图与原数组任何一方写入前
+// 才复制出独占的缓冲区（copy-on-write），只读的切片为 O(1)。
+// 视图存在期间原缓冲区保持存活。slice 只修改缓冲区头部的原子字段，
+// 多个线程可以同时从同一个只读数组切片。
+class Elements {
+public:
+  // 数组长度为 32 位无符号整数
+  static constexpr size_t kMaxSize = UINT32_MAX;
+  static constexpr size_t kMinSparseHoles = 1024;
+  static constexpr size_t kMaxPreallocatedSize = size_t(1) << 24;
+  static constexpr size_t kMinSharedSlice = 32;
+  static constexpr size_t kMinChunkedSize = 16384;
+  static constexpr size_t kMinChunkedMove = 2048;
+
+  Elements() = default;
+  // 长度为 size，全部为空位
+  explicit Elements(size_t size);
+  Elements(const ValueVariant *values, size_t count);
+
+  Elements(const Elements &other);
+  Elements(Elements &&other) noexcept;
+  Elements &operator=(const Elements &other);
+  Elements &operator=(Elements &&other) noexcept;
+  ~Elements();
+
+  ElementsKind kind() const { return kind_; }
+  // 长度，稀疏存储时包含空位
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  // 存在的元素个数，不含空位
+  size_t count() const;
+  bool has(size_t index) const;
+  // 返回不小于 from 的第一个存在的下标，没有时返回 size()
+  size_t nextIndex(size_t from) const;
+
+  // 以下访问要求 index < size()，读取空位得到 undefined
+  ValueVariant get(size_t index) const;
+  void set(size_t index, const ValueVariant &value);
+  // 写入任意下标，越过末尾时扩展长度，中间留下空位
+  void put(size_t index, const ValueVariant &value);
+
+  void push(const ValueVariant &value);
+  ValueVariant pop();
+  void insert(size_t pos, const ValueVariant *values, size_t count);
+  void erase(size_t pos, size_t count);
+  // 扩展部分为空位，缩短时删除多出的元素
+  void resize(size_t size);
+  void clear();
+
+  // [begin, end) 范围内的元素；较长的连续范围共享缓冲区，写入时才复制
+  Elements slice(size_t begin, size_t end) const;
+  // 复制 [begin, end) 范围内的元素，同构数组按字节整段复制
+  Elements copy(size_t begin, size_t end) const;
+
+  // 元素种类与 T 一致时返回连续的原始数据，否则返回 nullptr。
+  // T 为 int32_t、double 或 uint64_t。
+  template <typename T> const T *packedData() const {
+    static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, double> ||
+                      std::is_same_v<T, uint64_t>,
+                  "packed elements are int32_t, double or uint64_t");
+    return kind_ == kindOf<T>() ? static_cast<const T *>(data_) : nullptr;
+  }
+
+private:
+  template <typename T> static constexpr ElementsKind kindOf() {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      return ElementsKind::Int32;
+    } else if constexpr (std::is_same_v<T, double>) {
+      return ElementsKind::Double;
+    } else {
+      return ElementsKind::UInt64;
+    }
+  }
+
+  static ElementsKind kindFor(const ValueVariant &value);
+  static size_t elementBytes(ElementsKind kind) {
+    return kind == ElementsKind::Int32 ? sizeof(int32_t) : sizeof(uint64_t);
+  }
+
+  // 保证可以写入 kind 种类的值，必要时转为 Generic
+  void prepareFor(ElementsKind kind);
+  void convertToGeneric();
+  void convertToSparse();
+  // 把长度扩展到 size（大于 size()），新增的下标都是空位。
+  // preallocate 为 true 时（resize）长度不超过 kMaxPreallocatedSize 即保持连续
+  void grow(size_t size, bool preallocate);
+  // 追加 list 中 [begin, end) 范围的元素，保留其中的空位
+  void appendChunked(const ChunkedList &list, size_t begin, size_t end);
+  // 写入前调用：缓冲区被共享时复制出独占的缓冲区
+  void prepareWrite();
+  bool shouldChunk(size_t moved) const;
+  void convertToChunked();
+  // 分块存储按值重新建立连续存储，同构的数值元素重新得到紧密存储
+  void convertToPacked();
+  // 稀疏存储不再有空位时转回连续存储
+  void densifyIfFull();
+  void reserve(size_t capacity);
+  // 保证起点之前至少有 count 个空闲槽位
+  void reserveFront(size_t count);
+  void destroyRange(size_t begin, size_t end);
+  // 长度增加 added 后仍不超过 kMaxSize，否则抛出 std::length_error
+  void checkGrowth(size_t added) const;
+  void store(size_t index, const ValueVariant &value);
+
+  CompactValue *generic() const { return static_cast<CompactValue *>(data_); }
+  ElementsBuffer *buffer() const;
+  // 连续存储的第一个槽位地址（缓冲区头部之后）
+  void *allocation() const {
+    return data_ ? static_cast<char *>(data_) - front_ * elementBytes(kind_)
+                 : nullptr;
+  }
+  SparseElements *sparse() const {
+    return static_cast<SparseElements *>(data_);
+  }
+  // const 访问得到 const 的序列，读取不触及其写入缓存
+  ChunkedList *chunked() { return static_cast<ChunkedList *>(data_); }
+  const ChunkedList *chunked() const {
+    return static_cast<const ChunkedList *>(data_);
+  }
+
+  void *data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0; // 从 data_ 起可容纳的元素数
+  size_t front_ = 0;    // data_ 之前的空闲槽位数
+  ElementsKind kind_ = ElementsKind::Empty;
+  bool view_ = false; // 共享他人缓冲区的一段，front_ 为该段在缓冲区中的位置
+};
+
+} // namespace jobject
@@ -1,43 +1,122 @@
 #include "JObject.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cmath>
 #include <ctime>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
 
+#include "BuiltinTable.h"
+#include "StringTable.h"
+
 namespace jobject {
 
 namespace {
 
-/**
- * @brief Try to interpret a property name as a canonical array index.
- *
- * Accepts only pure decimal strings without leading zeros (except "0"),
- * matching JavaScript's canonical numeric index semantics.
- *
- * @param[in] name The property name to inspect.
- * @param[out] outIndex Receives the parsed index when the name is an index.
- * @return true if the name is a canonical array index, false otherwise.
- */
-bool tryParseArrayIndex(const std::string &name, size_t &outIndex) {
-  if (name.empty()) {
-    return false;
+ValueVariant readDescriptor(const PropertySlot &descriptor) {
+  if (descriptor.accessor && descriptor.accessor->getter) {
+    return descriptor.accessor->getter();
   }
-  if (name.size() > 1 && name[0] == '0') {
-    return false;
+  return descriptor.value.toVariant();
+}
+
+// 串行化绑定方法缓存的插入
+std::mutex &boundMethodsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+bool writeDescriptor(PropertySlot &descriptor, const ValueVariant &value) {
+  if (descriptor.accessor && descriptor.accessor->setter) {
+    descriptor.accessor->setter(value);
+    return true;
   }
-  for (const char ch : name) {
-    if (!std::isdigit(static_cast<unsigned char>(ch))) {
-      return false;
+  if (descriptor.writable()) {
+    descriptor.value = value;
+    return true;
+  }
+  return false;
+}
+
+// 原型对象：原型链由构造时指定的父原型决定
+class PrototypeObject : public JObject {
+public:
+  explicit PrototypeObject(const JObject *parent) : parent_(parent) {}
+  const JObject *getPrototype() const override { return parent_; }
+
+  // 记录内置方法全部定义后的 Shape；此后只要 Shape 未变（未增删属性），
+  // 自有属性恰为各内置方法，编号 i 的方法位于槽位 i
+  void sealBuiltins(BuiltinIndex builtins) {
+    builtins_ = builtins;
+    builtinShape_ = shape_;
+  }
+
+protected:
+  const PropertySlot *findPrototypeProperty(const std::string &name,
+                                            uint64_t hash) const override {
+    // 命中与否都由完美哈希表一次判定，不再查 Shape
+    if (shape_ && shape_ == builtinShape_) {
+      const uint32_t id = builtins_.find(name, hash);
+      return id == BuiltinIndex::kNotFound ? nullptr : &slots_[id];
     }
+    return findOwnProperty(name);
   }
-  try {
-    outIndex = static_cast<size_t>(std::stoull(name));
-  } catch (const std::exception &) {
-    return false;
+
+private:
+  const JObject *parent_;
+  BuiltinIndex builtins_;
+  std::shared_ptr<const Shape> builtinShape_;
+};
+
+// 内置方法；在方法表中的下标即其编号
+struct BuiltinMethod {
+  const char *name;
+  NativeMethod method;
+};
+
+template <size_t N>
+constexpr std::array<std::string_view, N>
+builtinNames(const BuiltinMethod (&methods)[N]) {
+  std::array<std::string_view, N> names{};
+  for (size_t i = 0; i < N; ++i) {
+    names[i] = methods[i].name;
   }
-  return true;
+  return names;
+}
+
+/**
+ * @brief Create a shared prototype object holding the given builtin methods.
+ *
+ * Prototypes are intentionally leaked so that objects outliving static
+ * destruction never observe a destroyed prototype. Lookups on the
+ * prototype go through the compile-time perfect hash table of the method
+ * names for as long as no properties are added to or removed from it.
+ *
+ * @param[in] parent The next object on the prototype chain, or nullptr.
+ * @param[in] methods Builtin method names and implementations.
+ * @param[in] builtins Perfect hash table built from the method names.
+ * @return Pointer to the process-wide prototype handle.
+ */
+template <size_t N>
+const Ref<JObject> *makePrototype(const JObject *parent,
+                                  const BuiltinMethod (&methods)[N],
+                                  const BuiltinTable<N> &builtins) {
+  auto proto = makeRef<PrototypeObject>(parent);
+  for (const auto &[name, method] : methods) {
+    // 与 JS 一致，内置方法不可枚举
+    jobject::utils::def_prop_val(*proto, name,
+                                 makeRef<JFunction>(name, method, nullptr),
+                                 true, false, true);
+  }
+  proto->sealBuiltins(builtins.index());
+  return new Ref<JObject>(std::move(proto));
+}
+
+ValueVariant objectToString(JObject &self, const std::vector<ValueVariant> &) {
+  return makeRef<JString>(self.toString());
 }
 
 } // namespace
@@ -47,103 +126,300 @@ bool tryParseArrayIndex(const std::string &name, size_t &outIndex) {
 // JObject 实现
 // =======================
 
-JObject::JObject() { initializeCommonProperties(); }
+JObject::JObject() : shape_(Shape::root()) { initializeCommonProperties(); }
+
+JObject::~JObject() { delete boundMethods_.load(std::memory_order_relaxed); }
 
 void JObject::initializeCommonProperties() {
-  // 不在这里添加toString属性，避免无限递归
-  // toString将在getPropertyInternal中按需创建
+  // toString等内置方法由 Object.prototype 提供，不占用实例属性
+}
+
+void JObject::keepOrder(bool) {}
+
+void JObject::reserveProperties(size_t count) {
+  if (shape_ && shape_->propertyCount() + count > Shape::kMaxProperties) {
+    convertToDictionaryMode();
+  }
+  if (shape_) {
+    slots_.reserve(slots_.size() + count);
+    return;
+  }
+  dictionary_->reserve(count);
+}
+
+PropertySlot *JObject::findOwnProperty(const std::string &name) {
+  return const_cast<PropertySlot *>(
+      static_cast<const JObject *>(this)->findOwnProperty(name));
+}
+
+const PropertySlot *
+JObject::findOwnProperty(const std::string &name) const {
+  if (shape_) {
+    const uint32_t slot = shape_->lookup(name);
+    return slot == Shape::kNotFound ? nullptr : &slots_[slot];
+  }
+  return dictionary_->find(name);
+}
+
+PropertySlot *JObject::findOwnProperty(Atom name) {
+  return const_cast<PropertySlot *>(
+      static_cast<const JObject *>(this)->findOwnProperty(name));
+}
+
+const PropertySlot *JObject::findOwnProperty(Atom name) const {
+  if (shape_) {
+    const uint32_t slot = shape_->lookup(name);
+    return slot == Shape::kNotFound ? nullptr : &slots_[slot];
+  }
+  return dictionary_->find(name.str(), name.hash());
+}
+
+void JObject::appendSlot(Atom name, PropertySlot slot) {
+  shape_ = shape_->addProperty(name);
+  slots_.emplace_back(std::move(slot));
+}
+
+bool JObject::popLastSlot(uint32_t slot) {
+  // 删除最后加入的属性只需回退到父 Shape，仍保持快速模式
+  if (slot + 1 != slots_.size()) {
+    return false;
+  }
+  shape_ = shape_->parent();
+  slots_.pop_back();
+  return true;
+}
+
+void JObject::addDictionaryProperty(const std::string &name,
+                                    PropertySlot slot) {
+  if (shape_) {
+    convertToDictionaryMode();
+  }
+  dictionary_->insert(name, std::move(slot));
 }
 
-void JObject::keepOrder(bool enable) { keepOrder_ = enable; }
+bool JObject::eraseDictionaryProperty(const std::string &name) {
+  return dictionary_->erase(name);
+}
+
+void JObject::convertToDictionaryMode() {
+  auto dictionary = std::make_unique<PropertyDictionary>();
+  dictionary->reserve(slots_.size());
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    const Atom key = shape_->keyAt(i);
+    dictionary->insert(key.str(), key.hash(), std::move(slots_[i]));
+  }
+  dictionary_ = std::move(dictionary);
+  shape_.reset();
+  slots_.clear();
+}
 
 bool JObject::defineProperty(const std::string &name,
                              const PropertyDescriptor &descriptor) {
-  if (properties_.find(name) == properties_.end()) {
-    insertionOrder_.push_back(name);
+  if (auto *existing = findOwnProperty(name)) {
+    *existing = PropertySlot(descriptor);
+    return true;
+  }
+  if (shape_ && shape_->propertyCount() < Shape::kMaxProperties) {
+    appendSlot(Atom::intern(name), PropertySlot(descriptor));
+    return true;
+  }
+  addDictionaryProperty(name, PropertySlot(descriptor));
+  return true;
+}
+
+bool JObject::defineProperty(Atom name, const PropertyDescriptor &descriptor) {
+  if (auto *existing = findOwnProperty(name)) {
+    *existing = PropertySlot(descriptor);
+    return true;
+  }
+  if (shape_ && shape_->propertyCount() < Shape::kMaxProperties) {
+    appendSlot(name, PropertySlot(descriptor));
+    return true;
   }
-  properties_[name] = descriptor;
+  addDictionaryProperty(name.str(), PropertySlot(descriptor));
   return true;
 }
 
 bool JObject::deleteProperty(const std::string &name) {
-  auto it = properties_.find(name);
-  if (it != properties_.end()) {
-    if (it->second.configurable) {
-      properties_.erase(it);
-      auto orderIt =
-          std::find(insertionOrder_.begin(), insertionOrder_.end(), name);
-      if (orderIt != insertionOrder_.end()) {
-        insertionOrder_.erase(orderIt);
-      }
+  if (shape_) {
+    const uint32_t slot = shape_->lookup(name);
+    if (slot == Shape::kNotFound || !slots_[slot].configurable()) {
+      return false;
+    }
+    if (popLastSlot(slot)) {
       return true;
     }
+    convertToDictionaryMode();
   }
-  return false;
+  return eraseDictionaryProperty(name);
+}
+
+bool JObject::deleteProperty(Atom name) {
+  if (shape_) {
+    const uint32_t slot = shape_->lookup(name);
+    if (slot == Shape::kNotFound || !slots_[slot].configurable()) {
+      return false;
+    }
+    if (popLastSlot(slot)) {
+      return true;
+    }
+    convertToDictionaryMode();
+  }
+  return eraseDictionaryProperty(name.str());
 }
 
 bool JObject::hasProperty(const std::string &name) const {
-  return properties_.find(name) != properties_.end();
+  return findOwnProperty(name) != nullptr;
+}
+
+bool JObject::hasProperty(Atom name) const {
+  if (!name.isArrayIndex() && findOwnProperty(name)) {
+    return true;
+  }
+  // 子类可能按类型解析该属性（如 length）
+  return hasProperty(name.str());
 }
 
 std::vector<std::string> JObject::getPropertyNames() const {
   std::vector<std::string> names;
-  names.reserve(properties_.size());
-  if (keepOrder_) {
-    for (const auto &name : insertionOrder_) {
-      auto it = properties_.find(name);
-      if (it != properties_.end() && it->second.enumerable) {
-        names.push_back(name);
+  if (shape_) {
+    // Shape 天然记录插入顺序
+    names.reserve(slots_.size());
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (slots_[i].enumerable()) {
+        names.push_back(shape_->keyAt(i).str());
       }
     }
-  } else {
-    for (const auto &pair : properties_) {
-      if (pair.second.enumerable) {
-        names.push_back(pair.first);
+    return names;
+  }
+  names.reserve(dictionary_->size());
+  dictionary_->forEach(
+      [&names](const std::string &name, const PropertySlot &slot) {
+        if (slot.enumerable()) {
+          names.push_back(name);
+        }
+      });
+  return names;
+}
+
+void JObject::forEachProperty(
+    const std::function<void(const std::string &, const ValueVariant &)>
+        &visitor) const {
+  if (shape_) {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (slots_[i].enumerable()) {
+        visitor(shape_->keyAt(i).str(), readDescriptor(slots_[i]));
       }
     }
+    return;
   }
-  return names;
+  dictionary_->forEach(
+      [&visitor](const std::string &name, const PropertySlot &slot) {
+        if (slot.enumerable()) {
+          visitor(name, readDescriptor(slot));
+        }
+      });
 }
 
 ValueVariant JObject::getProperty(const std::string &name) const {
   return getPropertyInternal(name);
 }
 
-ValueVariant JObject::getPropertyInternal(const std::string &name) const {
-  auto it = properties_.find(name);
-  if (it != properties_.end()) {
-    const auto &descriptor = it->second;
-    if (descriptor.getter) {
-      return descriptor.getter();
+ValueVariant JObject::getProperty(Atom name) const {
+  if (!name.isArrayIndex()) {
+    if (const auto *descriptor = findOwnProperty(name)) {
+      return readDescriptor(*descriptor);
     }
-    return descriptor.value;
   }
+  return getPropertyInternal(name.str());
+}
 
-  // 处理内置属性
-  if (name == "toString") {
-    auto toStringFunc = std::make_shared<JFunction>(
-        "toString", [this](const std::vector<ValueVariant> &) -> ValueVariant {
-          return std::make_shared<JString>(this->toString());
-        });
-    return toStringFunc;
+ValueVariant JObject::getPropertyInternal(const std::string &name) const {
+  if (const auto *descriptor = findOwnProperty(name)) {
+    return readDescriptor(*descriptor);
+  }
+
+  // 沿原型链查找内置方法及原型上的属性，名字只哈希一次
+  const uint64_t hash = hashBuiltinName(name);
+  for (const JObject *proto = getPrototype(); proto;
+       proto = proto->getPrototype()) {
+    if (const auto *descriptor = proto->findPrototypeProperty(name, hash)) {
+      if (descriptor->accessor && descriptor->accessor->getter) {
+        return descriptor->accessor->getter();
+      }
+      return bindMethod(descriptor->value.toVariant());
+    }
   }
 
   return JUndefined{};
 }
 
-bool JObject::setProperty(const std::string &name, const ValueVariant &value) {
-  auto it = properties_.find(name);
-  if (it != properties_.end()) {
-    auto &descriptor = it->second;
-    if (descriptor.setter) {
-      descriptor.setter(value);
-      return true;
-    }
-    if (descriptor.writable) {
-      descriptor.value = value;
-      return true;
+ValueVariant JObject::bindMethod(const ValueVariant &value) const {
+  const auto *function = std::get_if<Ref<JFunction>>(&value);
+  if (!function || !*function || !(*function)->isUnboundMethod()) {
+    return value;
+  }
+  const NativeMethod method = (*function)->getMethod();
+  auto find = [method](const BoundMethod *entry) -> const BoundMethod * {
+    for (; entry; entry = entry->next.get()) {
+      if (entry->method == method) {
+        return entry;
+      }
     }
-    return false;
+    return nullptr;
+  };
+  if (const auto *entry = find(boundMethods_.load(std::memory_order_acquire))) {
+    return entry->bound;
+  }
+
+  std::lock_guard<std::mutex> lock(boundMethodsMutex());
+  // 等锁期间其他线程可能已插入同一方法
+  BoundMethod *current = boundMethods_.load(std::memory_order_relaxed);
+  if (const auto *entry = find(current)) {
+    return entry->bound;
+  }
+  auto *node = new BoundMethod{
+      method,
+      makeRef<JFunction>((*function)->getName(), method,
+                         const_cast<JObject *>(this)),
+      std::unique_ptr<BoundMethod>(current)};
+  boundMethods_.store(node, std::memory_order_release);
+  return node->bound;
+}
+
+const Ref<JObject> &JObject::prototype() {
+  static constexpr BuiltinMethod kMethods[] = {{"toString", &objectToString}};
+  static constexpr BuiltinTable kBuiltins(builtinNames(kMethods));
+  static const auto *proto = makePrototype(nullptr, kMethods, kBuiltins);
+  return *proto;
+}
+
+const JObject *JObject::getPrototype() const { return prototype().get(); }
+
+const PropertySlot *JObject::findPrototypeProperty(const std::string &name,
+                                                   uint64_t) const {
+  return findOwnProperty(name);
+}
+
+ValueVariant JObject::getSlotValue(uint32_t slot) const {
+  return readDescriptor(slots_[slot]);
+}
+
+void JObject::initializeSlots(std::shared_ptr<const Shape> shape,
+                              const ValueVariant *values) {
+  const size_t count = shape->propertyCount();
+  slots_.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    slots_.emplace_back(values[i]);
+  }
+  shape_ = std::move(shape);
+}
+
+bool JObject::interceptsProperty(const std::string &) const { return false; }
+
+bool JObject::setProperty(const std::string &name, const ValueVariant &value) {
+  if (auto *existing = findOwnProperty(name)) {
+    return writeDescriptor(*existing, value);
   } else {
     // 创建新属性
     PropertyDescriptor descriptor;
@@ -152,6 +428,21 @@ bool JObject::setProperty(const std::string &name, const ValueVariant &value) {
   }
 }
 
+bool JObject::setProperty(Atom name, const ValueVariant &value) {
+  if (name.isArrayIndex()) {
+    return setProperty(name.str(), value);
+  }
+  if (auto *existing = findOwnProperty(name)) {
+    return writeDescriptor(*existing, value);
+  }
+  if (interceptsProperty(name.str())) {
+    return setProperty(name.str(), value);
+  }
+  PropertyDescriptor descriptor;
+  descriptor.value = value;
+  return defineProperty(name, descriptor);
+}
+
 void JObject::setPropertyValue(const std::string &name,
                                const ValueVariant &value) {
   setProperty(name, value);
@@ -167,7 +458,7 @@ std::string JObject::toString() const { return "[object Object]"; }
 // JString 实现
 // =======================
 
-JString::JString(const std::string &str) : value_(str) {
+JString::JString(std::string str) : value_(std::move(str)) {
   initializeStringProperties();
 }
 
@@ -176,119 +467,705 @@ JString::JString(const char *str) : value_(str ? str : "") {
 }
 
 void JString::initializeStringProperties() {
-  // length属性
-  jobject::utils::def_prop_ex(
-      *this, "length",
-      [this]() -> ValueVariant {
-        return static_cast<uint32_t>(value_.length());
-      },
-      nullptr, false, false, false);
+  // length 在 getPropertyInternal 中按类型解析，其他方法由 String.prototype
+  // 提供，构造字符串不创建任何实例属性
+  charset_.store(utils::isAscii(value_) ? Charset::Ascii : Charset::NonAscii,
+                 std::memory_order_relaxed);
+}
+
+bool JString::hasProperty(const std::string &name) const {
+  return name == "length" || JObject::hasProperty(name);
+}
+
+bool JString::setProperty(const std::string &name, const ValueVariant &value) {
+  if (name == "length" && !findOwnProperty(name)) {
+    return false; // 只读
+  }
+  return JObject::setProperty(name, value);
+}
 
-  // 其他方法将在getPropertyInternal中按需创建，避免递归
+ValueVariant JString::getPropertyInternal(const std::string &name) const {
+  if (name == "length" && !findOwnProperty(name)) {
+    return static_cast<uint32_t>(Utf16Length());
+  }
+  return JObject::getPropertyInternal(name);
+}
+
+bool JString::interceptsProperty(const std::string &name) const {
+  return name == "length";
+}
+
+JString::~JString() {
+  if (interned_) {
+    StringTable::remove(this);
+  }
+  detachShared();
+  delete index_.load(std::memory_order_relaxed);
 }
 
-size_t JString::Size() const { return value_.size(); }
+size_t JString::Size() const {
+  if (rope_) {
+    return rope_->length;
+  }
+  return slice_ ? slice_->text.length : value_.size();
+}
 
-bool JString::Empty() const { return value_.empty(); }
+bool JString::Empty() const { return Size() == 0; }
 
-void JString::Clear() { value_.clear(); }
+bool JString::Clear() {
+  if (interned_) {
+    return false; // 驻留字符串为所有持有者共享，不可修改
+  }
+  releaseContent();
+  value_.clear();
+  charset_.store(Charset::Ascii, std::memory_order_relaxed);
+  return true;
+}
 
 char JString::At(size_t index) const {
-  if (index >= value_.size())
+  const std::string_view value = view();
+  if (index >= value.size())
     return '\0';
-  return value_[index];
+  return value[index];
 }
 
-char JString::Front() const { return value_.empty() ? '\0' : value_.front(); }
+char JString::Front() const {
+  const std::string_view value = view();
+  return value.empty() ? '\0' : value.front();
+}
 
-char JString::Back() const { return value_.empty() ? '\0' : value_.back(); }
+char JString::Back() const {
+  const std::string_view value = view();
+  return value.empty() ? '\0' : value.back();
+}
 
-std::string JString::toString() const { return value_; }
+std::string JString::toString() const { return std::string(view()); }
 
-void JString::setValue(const std::string &value) { value_ = value; }
+bool JString::setValue(const std::string &value) {
+  if (interned_) {
+    return false; // 同 Clear
+  }
+  releaseContent();
+  value_ = value;
+  initializeStringProperties();
+  return true;
+}
 
-ValueVariant JString::getPropertyInternal(const std::string &name) const {
-  // 处理JString特有的方法
-  if (name == "concat") {
-    auto concatFunc = std::make_shared<JFunction>(
-        "concat",
-        [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          std::string result = value_;
-          for (const auto &arg : args) {
-            result += utils::valueToString(arg);
-          }
-          return std::make_shared<JString>(result);
-        });
-    return concatFunc;
-  } else if (name == "indexOf") {
-    auto indexOfFunc = std::make_shared<JFunction>(
-        "indexOf",
-        [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          if (args.empty())
-            return static_cast<int32_t>(-1);
-          std::string searchStr = utils::valueToString(args[0]);
-          size_t pos = value_.find(searchStr);
-          return pos == std::string::npos ? static_cast<int32_t>(-1)
-                                          : static_cast<int32_t>(pos);
-        });
-    return indexOfFunc;
-  } else if (name == "lastIndexOf") {
-    auto lastIndexOfFunc = std::make_shared<JFunction>(
-        "lastIndexOf",
-        [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          if (args.empty())
-            return static_cast<int32_t>(-1);
-          std::string searchStr = utils::valueToString(args[0]);
-          size_t pos = value_.rfind(searchStr);
-          return pos == std::string::npos ? static_cast<int32_t>(-1)
-                                          : static_cast<int32_t>(pos);
-        });
-    return lastIndexOfFunc;
-  }
-
-  // 调用父类方法处理通用属性
-  return JObject::getPropertyInternal(name);
+bool JString::IsAscii() const {
+  Charset charset = charset_.load(std::memory_order_relaxed);
+  if (charset == Charset::Unknown) {
+    // 并发检测得到相同结果，重复写入无害
+    charset = utils::isAscii(view()) ? Charset::Ascii : Charset::NonAscii;
+    charset_.store(charset, std::memory_order_relaxed);
+  }
+  return charset == Charset::Ascii;
 }
 
+bool JString::Equals(const JString &other) const {
+  if (this == &other) {
+    return true;
+  }
+  // 内容相同的驻留字符串必然是同一个对象
+  if (interned_ && other.interned_) {
+    return false;
+  }
+  if (Size() != other.Size()) {
+    return false;
+  }
+  const size_t hash = hash_.load(std::memory_order_relaxed);
+  const size_t otherHash = other.hash_.load(std::memory_order_relaxed);
+  if (hash != 0 && otherHash != 0 && hash != otherHash) {
+    return false;
+  }
+  return view() == other.view();
+}
+
+size_t JString::computeHash() const {
+  const size_t hash = hashOf(view());
+  hash_.store(hash, std::memory_order_relaxed);
+  return hash;
+}
+
+size_t JString::hashOf(std::string_view text) {
+  const size_t hash = std::hash<std::string_view>{}(text);
+  return hash != 0 ? hash : 1;
+}
+
+size_t JString::CodePointLength() const {
+  return IsAscii() ? Size() : utf8Index().codePointCount();
+}
+
+uint32_t JString::CodePointAt(size_t index) const {
+  const std::string_view text = view();
+  if (IsAscii()) {
+    return index < text.size() ? static_cast<unsigned char>(text[index]) : 0;
+  }
+  const Utf8Index &index8 = utf8Index();
+  if (index >= index8.codePointCount()) {
+    return 0;
+  }
+  const char *p = text.data() + index8.codePoint(text, index).byte;
+  return utils::decodeUtf8(p, text.data() + text.size());
+}
+
+size_t JString::Utf16Length() const {
+  return IsAscii() ? Size() : utf8Index().utf16Length();
+}
+
+char16_t JString::Utf16At(size_t index) const {
+  const std::string_view text = view();
+  if (IsAscii()) {
+    return index < text.size() ? static_cast<unsigned char>(text[index]) : 0;
+  }
+  const Utf8Index &index8 = utf8Index();
+  if (index >= index8.utf16Length()) {
+    return 0;
+  }
+  const Utf8Index::Position position = index8.utf16Unit(text, index);
+  const char *p = text.data() + position.byte;
+  const uint32_t codePoint = utils::decodeUtf8(p, text.data() + text.size());
+  if (codePoint < 0x10000) {
+    return static_cast<char16_t>(codePoint);
+  }
+  const uint32_t offset = codePoint - 0x10000;
+  return static_cast<char16_t>(index == position.unit
+                                   ? 0xD800 + (offset >> 10)
+                                   : 0xDC00 + (offset & 0x3FF));
+}
+
+size_t JString::Utf16ToByteOffset(size_t unit) const {
+  if (IsAscii()) {
+    return std::min(unit, Size());
+  }
+  const Utf8Index &index8 = utf8Index();
+  return index8.utf16Unit(view(), std::min(unit, index8.utf16Length())).byte;
+}
+
+size_t JString::ByteToUtf16Offset(size_t byte) const {
+  const std::string_view text = view();
+  byte = std::min(byte, text.size());
+  return IsAscii() ? byte : utf8Index().utf16Offset(text, byte);
+}
+
+namespace {
+
+// 短于此长度的拼接结果直接复制，省去额外的段对象
+constexpr size_t kMinRopeLength = 256;
+
+// 不足此长度的子串直接复制（通常落在 std::string 的内联缓冲中）
+constexpr size_t kMinSharedSubstring = 32;
+
+// 持有字节的字符串只剩某个子串引用时，从该子串再取出的子串若不足
+// 其 1/8 则复制，避免很小的片段让整个大字符串一直存活
+constexpr size_t kMaxPinnedRatio = 8;
+
+// 展平、复制子串与建立路标索引可能发生在多个线程共享的只读字符串上，
+// 写入缓存时串行化
+std::mutex &contentMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+} // namespace
+
+Ref<JString> JString::Concat(const ValueVariant *values, size_t count) const {
+  // 非字符串的值先转换；转换可能读取其他字符串，不能在持锁时进行
+  std::vector<Ref<JString>> strings;
+  strings.reserve(count + 1);
+  strings.emplace_back(const_cast<JString *>(this));
+  size_t length = Size();
+  for (size_t i = 0; i < count; ++i) {
+    const auto *str = std::get_if<Ref<JString>>(&values[i]);
+    strings.push_back(str && *str
+                          ? *str
+                          : makeRef<JString>(utils::valueToString(values[i])));
+    length += strings.back()->Size();
+  }
+
+  if (length < kMinRopeLength) {
+    std::string result;
+    result.reserve(length);
+    for (const auto &piece : strings) {
+      result += piece->view();
+    }
+    return makeRef<JString>(std::move(result));
+  }
+
+  // 各段都是 ASCII 时结果也是；任一段已知含非 ASCII 时结果同样已知
+  Charset charset = Charset::Ascii;
+  for (const auto &piece : strings) {
+    const Charset pieceCharset = piece->charset_.load(std::memory_order_relaxed);
+    if (pieceCharset == Charset::NonAscii) {
+      charset = Charset::NonAscii;
+      break;
+    }
+    if (pieceCharset == Charset::Unknown) {
+      charset = Charset::Unknown;
+    }
+  }
+
+  // 各段在此取得快照：较长的段共享字节，较短的相邻段合并复制为一段
+  auto node = makeRef<RopeNode>();
+  std::string run;
+  for (const auto &piece : strings) {
+    piece->appendPieces(node->pieces, run);
+  }
+  if (!run.empty()) {
+    auto bytes = makeRef<SharedBytes>();
+    bytes->size = run.size();
+    bytes->bytes = std::move(run);
+    node->pieces.push_back(
+        {nullptr, {bytes, bytes->bytes.data(), bytes->bytes.size()}});
+  }
+
+  auto result = makeRef<JString>();
+  result->charset_.store(charset, std::memory_order_relaxed);
+  result->rope_ = std::make_unique<Rope>();
+  result->rope_->node = std::move(node);
+  result->rope_->length = length;
+  return result;
+}
+
+void JString::appendPieces(std::vector<RopeNode::Piece> &pieces,
+                           std::string &run) const {
+  auto flushRun = [&pieces, &run]() {
+    if (run.empty()) {
+      return;
+    }
+    auto bytes = makeRef<SharedBytes>();
+    bytes->size = run.size();
+    bytes->bytes = std::move(run);
+    run = std::string();
+    pieces.push_back(
+        {nullptr, {bytes, bytes->bytes.data(), bytes->bytes.size()}});
+  };
+
+  std::lock_guard<std::mutex> lock(contentMutex());
+  if (rope_ && !rope_->flat.load(std::memory_order_relaxed)) {
+    // 节点不可变，直接共享
+    flushRun();
+    pieces.push_back({rope_->node, {}});
+    return;
+  }
+  if (Size() < kMinSharedSubstring) {
+    if (slice_) {
+      run.append(slice_->text.data, slice_->text.length);
+    } else {
+      run += value_;
+    }
+    return;
+  }
+  flushRun();
+  pieces.push_back({nullptr, sharedSegment()});
+}
+
+JString::Segment JString::sharedSegment() const {
+  if (slice_) {
+    return slice_->text;
+  }
+  // 展平后的拼接结果与普通字符串一样由 value_ 持有内容
+  if (!shared_) {
+    shared_ = makeRef<SharedBytes>();
+    shared_->size = value_.size();
+  }
+  return {shared_, value_.data(), value_.size()};
+}
+
+void JString::detachShared() {
+  if (!shared_) {
+    return;
+  }
+  if (shared_->refCount() > 1) {
+    shared_->bytes = std::move(value_);
+    value_ = std::string();
+  }
+  shared_.reset();
+}
+
+size_t JString::IndexOf(std::string_view needle, size_t from) const {
+  return utils::indexOf(view(), needle, from);
+}
+
+size_t JString::LastIndexOf(std::string_view needle, size_t from) const {
+  return utils::lastIndexOf(view(), needle, from);
+}
+
+Ref<JString> JString::Substring(size_t begin, size_t end) const {
+  const std::string_view text = view();
+  end = std::min(end, text.size());
+  begin = std::min(begin, end);
+  const size_t length = end - begin;
+  if (length < kMinSharedSubstring) {
+    return makeRef<JString>(std::string(text.substr(begin, length)));
+  }
+  Segment source;
+  {
+    std::lock_guard<std::mutex> lock(contentMutex());
+    source = sharedSegment();
+  }
+  // 字节只剩本子串引用（原字符串已修改或释放）时，很小的片段复制出来，
+  // 不让整段字节一直存活
+  if (slice_ && source.bytes->refCount() == 2 &&
+      length * kMaxPinnedRatio < source.bytes->size) {
+    return makeRef<JString>(std::string(text.substr(begin, length)));
+  }
+  auto result = makeRef<JString>();
+  result->slice_ = std::make_unique<Slice>();
+  result->slice_->text = {std::move(source.bytes), text.data() + begin,
+                          length};
+  // ASCII 字符串的子串仍是 ASCII，否则留到首次使用时检测
+  result->charset_.store(charset_.load(std::memory_order_relaxed) ==
+                                 Charset::Ascii
+                             ? Charset::Ascii
+                             : Charset::Unknown,
+                         std::memory_order_relaxed);
+  return result;
+}
+
+Ref<JArray> JString::Split(std::string_view separator, size_t limit) const {
+  auto result = utils::createArray();
+  const std::string_view text = view();
+  if (limit == 0) {
+    return result;
+  }
+  if (separator.empty()) {
+    const char *end = text.data() + text.size();
+    for (const char *p = text.data(); p < end && result->Size() < limit;) {
+      const char *start = p;
+      utils::decodeUtf8(p, end);
+      result->Push(makeRef<JString>(std::string(start, p)));
+    }
+    return result;
+  }
+  size_t begin = 0;
+  while (result->Size() < limit) {
+    const size_t pos = text.find(separator, begin);
+    if (pos == std::string_view::npos) {
+      result->Push(Substring(begin, text.size()));
+      break;
+    }
+    result->Push(Substring(begin, pos));
+    begin = pos + separator.size();
+  }
+  return result;
+}
+
+const std::string &JString::indirectValue() const {
+  if (rope_) {
+    if (!rope_->flat.load(std::memory_order_acquire)) {
+      flatten();
+    }
+    return value_;
+  }
+  if (!slice_->copied.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(contentMutex());
+    if (!slice_->copied.load(std::memory_order_relaxed)) {
+      value_.assign(slice_->text.data, slice_->text.length);
+      slice_->copied.store(true, std::memory_order_release);
+    }
+  }
+  return value_;
+}
+
+void JString::flatten() const {
+  std::lock_guard<std::mutex> lock(contentMutex());
+  if (rope_->flat.load(std::memory_order_relaxed)) {
+    return;
+  }
+  std::string result;
+  result.reserve(rope_->length);
+  // 按从左到右的顺序深度优先收集各段；显式栈避免长拼接链递归
+  std::vector<const RopeNode::Piece *> stack;
+  const auto &pieces = rope_->node->pieces;
+  for (auto it = pieces.rbegin(); it != pieces.rend(); ++it) {
+    stack.push_back(&*it);
+  }
+  while (!stack.empty()) {
+    const RopeNode::Piece *piece = stack.back();
+    stack.pop_back();
+    if (piece->node) {
+      const auto &children = piece->node->pieces;
+      for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        stack.push_back(&*it);
+      }
+    } else {
+      result.append(piece->text.data, piece->text.length);
+    }
+  }
+  value_ = std::move(result);
+  // 展平后不再需要各段；其他线程此时只会读取 length 与 flat，
+  // 取得各段快照的 appendPieces 同样持有 contentMutex
+  rope_->node.reset();
+  rope_->flat.store(true, std::memory_order_release);
+}
+
+const Utf8Index &JString::utf8Index() const {
+  const Utf8Index *index = index_.load(std::memory_order_acquire);
+  if (!index) {
+    const std::string_view text = view();
+    std::lock_guard<std::mutex> lock(contentMutex());
+    index = index_.load(std::memory_order_relaxed);
+    if (!index) {
+      index = new Utf8Index(text);
+      index_.store(index, std::memory_order_release);
+    }
+  }
+  return *index;
+}
+
+void JString::releaseContent() {
+  detachShared();
+  rope_.reset();
+  slice_.reset();
+  delete index_.exchange(nullptr, std::memory_order_relaxed);
+  hash_.store(0, std::memory_order_relaxed);
+}
+
+JString::RopeNode::~RopeNode() {
+  std::vector<Ref<RopeNode>> pending;
+  for (auto &piece : pieces) {
+    if (piece.node) {
+      pending.push_back(std::move(piece.node));
+    }
+  }
+  while (!pending.empty()) {
+    Ref<RopeNode> node = std::move(pending.back());
+    pending.pop_back();
+    // 只被本链引用的子节点先交出自己的子节点，随后释放时不再递归
+    if (node->refCount() == 1) {
+      for (auto &piece : node->pieces) {
+        if (piece.node) {
+          pending.push_back(std::move(piece.node));
+        }
+      }
+    }
+  }
+}
+
+namespace {
+
+ValueVariant stringConcat(JObject &self,
+                          const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str)
+    return JUndefined{};
+  return str->Concat(args.data(), args.size());
+}
+
+// 把下标参数截断到 [0, size]；relative 为 true 时负数从末尾起算（slice 语义）
+size_t stringIndexArg(const std::vector<ValueVariant> &args, size_t i,
+                      size_t size, size_t fallback, bool relative) {
+  if (i >= args.size() || std::holds_alternative<JUndefined>(args[i]))
+    return fallback;
+  double index = std::trunc(utils::toNumber(args[i]));
+  if (std::isnan(index))
+    index = 0;
+  if (relative && index < 0)
+    index += static_cast<double>(size);
+  return static_cast<size_t>(
+      std::clamp(index, 0.0, static_cast<double>(size)));
+}
+
+// 查找参数：字符串直接读取其内容，其他值转换为字符串
+std::string_view searchArg(const std::vector<ValueVariant> &args,
+                           std::string &scratch) {
+  if (const auto *str = std::get_if<Ref<JString>>(&args[0])) {
+    if (*str)
+      return (*str)->view();
+  }
+  scratch = utils::valueToString(args[0]);
+  return scratch;
+}
+
+// 字节偏移的查找结果转换为 UTF-16 偏移
+ValueVariant searchResult(const JString &str, size_t pos) {
+  return pos == std::string_view::npos
+             ? static_cast<int32_t>(-1)
+             : static_cast<int32_t>(str.ByteToUtf16Offset(pos));
+}
+
+ValueVariant stringIndexOf(JObject &self,
+                           const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str || args.empty())
+    return static_cast<int32_t>(-1);
+  std::string scratch;
+  const std::string_view needle = searchArg(args, scratch);
+  const size_t from = stringIndexArg(args, 1, str->Utf16Length(), 0, false);
+  return searchResult(*str,
+                      str->IndexOf(needle, str->Utf16ToByteOffset(from)));
+}
+
+ValueVariant stringLastIndexOf(JObject &self,
+                               const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str || args.empty())
+    return static_cast<int32_t>(-1);
+  std::string scratch;
+  const std::string_view needle = searchArg(args, scratch);
+  size_t from = std::string_view::npos;
+  if (args.size() > 1 && !std::isnan(utils::toNumber(args[1])))
+    from = str->Utf16ToByteOffset(
+        stringIndexArg(args, 1, str->Utf16Length(), from, false));
+  return searchResult(*str, str->LastIndexOf(needle, from));
+}
+
+ValueVariant stringSubstring(JObject &self,
+                             const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str)
+    return JUndefined{};
+  const size_t size = str->Utf16Length();
+  size_t start = stringIndexArg(args, 0, size, 0, false);
+  size_t end = stringIndexArg(args, 1, size, size, false);
+  if (start > end)
+    std::swap(start, end);
+  return str->Substring(str->Utf16ToByteOffset(start),
+                        str->Utf16ToByteOffset(end));
+}
+
+ValueVariant stringSlice(JObject &self, const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str)
+    return JUndefined{};
+  const size_t size = str->Utf16Length();
+  const size_t start = stringIndexArg(args, 0, size, 0, true);
+  const size_t end = stringIndexArg(args, 1, size, size, true);
+  return str->Substring(str->Utf16ToByteOffset(start),
+                        str->Utf16ToByteOffset(std::max(start, end)));
+}
+
+ValueVariant stringSplit(JObject &self, const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str)
+    return JUndefined{};
+  size_t limit = SIZE_MAX;
+  if (args.size() > 1 && !std::holds_alternative<JUndefined>(args[1])) {
+    // ToUint32：按 2^32 取模，NaN 与无穷为 0
+    const double value = std::trunc(utils::toNumber(args[1]));
+    double wrapped = std::isfinite(value) ? std::fmod(value, 4294967296.0) : 0;
+    if (wrapped < 0)
+      wrapped += 4294967296.0;
+    limit = static_cast<size_t>(wrapped);
+  }
+  if (args.empty() || std::holds_alternative<JUndefined>(args[0])) {
+    auto result = utils::createArray();
+    if (limit > 0)
+      result->Push(str->Substring(0, str->Size()));
+    return result;
+  }
+  return str->Split(utils::valueToString(args[0]), limit);
+}
+
+// 单元下标参数：缺省为 0，越界时返回 false
+bool stringPositionArg(const JString &str,
+                       const std::vector<ValueVariant> &args, size_t &unit) {
+  double position = args.empty() ? 0 : std::trunc(utils::toNumber(args[0]));
+  if (std::isnan(position))
+    position = 0;
+  if (position < 0 || position >= static_cast<double>(str.Utf16Length()))
+    return false;
+  unit = static_cast<size_t>(position);
+  return true;
+}
+
+// 返回 pos 处单元所在的整个码点（UTF-8 无法单独表示代理对中的一半）
+ValueVariant stringCharAt(JObject &self,
+                          const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str)
+    return JUndefined{};
+  size_t unit = 0;
+  if (!stringPositionArg(*str, args, unit))
+    return utils::createString();
+  const char16_t code = str->Utf16At(unit);
+  const bool highSurrogate = code >= 0xD800 && code < 0xDC00;
+  return str->Substring(str->Utf16ToByteOffset(unit),
+                        str->Utf16ToByteOffset(unit + (highSurrogate ? 2 : 1)));
+}
+
+ValueVariant stringCharCodeAt(JObject &self,
+                              const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str)
+    return JUndefined{};
+  size_t unit = 0;
+  if (!stringPositionArg(*str, args, unit))
+    return std::nan("");
+  return static_cast<int32_t>(str->Utf16At(unit));
+}
+
+ValueVariant stringCodePointAt(JObject &self,
+                               const std::vector<ValueVariant> &args) {
+  auto *str = dynamic_cast<JString *>(&self);
+  if (!str)
+    return JUndefined{};
+  size_t unit = 0;
+  if (!stringPositionArg(*str, args, unit))
+    return JUndefined{};
+  const char16_t code = str->Utf16At(unit);
+  if (code < 0xD800 || code >= 0xDC00)
+    return static_cast<int32_t>(code); // BMP 码点或代理对的低位单元
+  const char16_t low = str->Utf16At(unit + 1);
+  return static_cast<int32_t>(0x10000 + ((code - 0xD800) << 10) +
+                              (low - 0xDC00));
+}
+
+} // namespace
+
+const Ref<JObject> &JString::prototype() {
+  static constexpr BuiltinMethod kMethods[] = {
+      {"concat", &stringConcat},
+      {"indexOf", &stringIndexOf},
+      {"lastIndexOf", &stringLastIndexOf},
+      {"substring", &stringSubstring},
+      {"slice", &stringSlice},
+      {"split", &stringSplit},
+      {"charAt", &stringCharAt},
+      {"charCodeAt", &stringCharCodeAt},
+      {"codePointAt", &stringCodePointAt}};
+  static constexpr BuiltinTable kBuiltins(builtinNames(kMethods));
+  static const auto *proto =
+      makePrototype(JObject::prototype().get(), kMethods, kBuiltins);
+  return *proto;
+}
+
+const JObject *JString::getPrototype() const { return prototype().get(); }
+
 // =======================
 // JArray 实现
 // =======================
 
-JArray::JArray(size_t size) : value_(size) { initializeArrayProperties(); }
+JArray::JArray(size_t size) : elements_(size) { initializeArrayProperties(); }
 
-JArray::JArray(const std::vector<ValueVariant> &values) : value_(values) {
+JArray::JArray(const std::vector<ValueVariant> &values)
+    : elements_(values.data(), values.size()) {
   initializeArrayProperties();
 }
 
-void JArray::initializeArrayProperties() {
-  // length属性
-  jobject::utils::def_prop_ex(
-      *this, "length",
-      [this]() -> ValueVariant { return static_cast<uint32_t>(value_.size()); },
-      [this](const ValueVariant &val) {
-        if (std::holds_alternative<uint32_t>(val)) {
-          uint32_t newSize = std::get<uint32_t>(val);
-          value_.resize(newSize);
-        }
-      },
-      true, false, false);
+JArray::JArray(const ValueVariant *values, size_t count)
+    : elements_(values, count) {
+  initializeArrayProperties();
+}
 
-  // 数字索引与其它方法均在 getPropertyInternal 中按需解析，避免递归与
-  // 每次修改数组时重建索引属性描述符带来的 O(n) 开销。
+void JArray::initializeArrayProperties() {
+  // 数字索引与 length 在 getPropertyInternal 中按需解析，避免每次修改数组时
+  // 重建属性描述符带来的开销；内置方法由 Array.prototype 提供。
 }
 
 bool JArray::hasProperty(const std::string &name) const {
   size_t index = 0;
   if (tryParseArrayIndex(name, index)) {
-    return index < value_.size();
+    return elements_.has(index);
   }
-  return JObject::hasProperty(name);
+  return name == "length" || JObject::hasProperty(name);
 }
 
 std::vector<std::string> JArray::getPropertyNames() const {
   std::vector<std::string> names;
-  names.reserve(value_.size());
-  for (size_t i = 0; i < value_.size(); ++i) {
+  names.reserve(elements_.count());
+  for (size_t i = elements_.nextIndex(0); i < elements_.size();
+       i = elements_.nextIndex(i + 1)) {
     names.push_back(std::to_string(i));
   }
   // 追加非索引的可枚举命名属性。
@@ -303,56 +1180,120 @@ std::vector<std::string> JArray::getPropertyNames() const {
 
 bool JArray::setProperty(const std::string &name, const ValueVariant &value) {
   size_t index = 0;
-  if (tryParseArrayIndex(name, index) && index < value_.size()) {
-    value_[index] = value;
+  if (tryParseArrayIndex(name, index)) {
+    setElement(index, value);
+    return true;
+  }
+  if (name == "length" && !findOwnProperty(name)) {
+    if (std::holds_alternative<uint32_t>(value)) {
+      elements_.resize(std::get<uint32_t>(value));
+    }
     return true;
   }
   return JObject::setProperty(name, value);
 }
 
-size_t JArray::Size() const { return value_.size(); }
+size_t JArray::Size() const { return elements_.size(); }
+
+bool JArray::Empty() const { return elements_.empty(); }
+
+bool JArray::Has(size_t index) const { return elements_.has(index); }
 
-bool JArray::Empty() const { return value_.empty(); }
+size_t JArray::NextIndex(size_t from) const {
+  return elements_.nextIndex(from);
+}
 
-void JArray::Clear() { value_.clear(); }
+void JArray::Clear() { elements_.clear(); }
 
-void JArray::Push(const ValueVariant &value) { value_.push_back(value); }
+void JArray::Push(const ValueVariant &value) { elements_.push(value); }
 
 ValueVariant JArray::Pop() {
-  if (value_.empty())
+  if (elements_.empty())
+    return JUndefined{};
+  return elements_.pop();
+}
+
+ValueVariant JArray::Shift() {
+  if (elements_.empty())
     return JUndefined{};
-  ValueVariant result = value_.back();
-  value_.pop_back();
+  ValueVariant result = elements_.get(0);
+  elements_.erase(0, 1);
   return result;
 }
 
+void JArray::Unshift(const ValueVariant *values, size_t count) {
+  elements_.insert(0, values, count);
+}
+
+Ref<JArray> JArray::Splice(size_t start, size_t deleteCount,
+                                       const ValueVariant *items,
+                                       size_t count) {
+  start = std::min(start, elements_.size());
+  deleteCount = std::min(deleteCount, elements_.size() - start);
+
+  // 创建被删除的元素数组
+  auto deletedArray = utils::createArray();
+  deletedArray->elements_ = elements_.copy(start, start + deleteCount);
+
+  // 删除元素
+  elements_.erase(start, deleteCount);
+
+  // 插入新元素
+  elements_.insert(start, items, count);
+
+  return deletedArray;
+}
+
+Ref<JArray> JArray::Slice(size_t begin, size_t end) const {
+  end = std::min(end, elements_.size());
+  auto sliced = utils::createArray();
+  sliced->elements_ = elements_.slice(begin, end);
+  return sliced;
+}
+
 ValueVariant JArray::At(size_t index) const {
-  if (index >= value_.size())
-    return JUndefined{};
-  return value_[index];
+  if (index >= elements_.size()) {
+    return index > kMaxArrayIndex
+               ? JObject::getPropertyInternal(std::to_string(index))
+               : ValueVariant{JUndefined{}};
+  }
+  return elements_.get(index);
 }
 
 ValueVariant JArray::Front() const {
-  return value_.empty() ? ValueVariant{JUndefined{}} : value_.front();
+  return elements_.empty() ? ValueVariant{JUndefined{}} : elements_.get(0);
 }
 
 ValueVariant JArray::Back() const {
-  return value_.empty() ? ValueVariant{JUndefined{}} : value_.back();
+  return elements_.empty() ? ValueVariant{JUndefined{}}
+                           : elements_.get(elements_.size() - 1);
+}
+
+std::vector<ValueVariant> JArray::toVector() const {
+  std::vector<ValueVariant> values;
+  values.reserve(elements_.size());
+  for (size_t i = 0; i < elements_.size(); ++i) {
+    values.push_back(elements_.get(i));
+  }
+  return values;
 }
 
 void JArray::setElement(size_t index, const ValueVariant &value) {
-  if (index >= value_.size()) {
-    value_.resize(index + 1);
+  if (index > kMaxArrayIndex) {
+    // 超出下标范围的数字按普通属性保存，与属性名 "4294967295" 一致
+    JObject::setProperty(std::to_string(index), value);
+    return;
   }
-  value_[index] = value;
+  // 远超当前长度的下标会使元素存储转为稀疏，不会按下标分配空间
+  elements_.put(index, value);
 }
 
 std::string JArray::toString() const {
   std::ostringstream oss;
-  for (size_t i = 0; i < value_.size(); ++i) {
+  for (size_t i = 0; i < elements_.size(); ++i) {
     if (i > 0)
       oss << ",";
-    oss << utils::valueToString(value_[i]);
+    oss << utils::valueToString(elements_.get(i));
   }
   return oss.str();
 }
@@ -361,137 +1302,123 @@ ValueVariant JArray::getPropertyInternal(const std::string &name) const {
   // 数字索引按需解析，避免维护索引属性描述符
   size_t index = 0;
   if (tryParseArrayIndex(name, index)) {
-    return index < value_.size() ? value_[index] : ValueVariant{JUndefined{}};
-  }
-
-  // 处理JArray特有的方法
-  if (name == "push") {
-    auto pushFunc = std::make_shared<JFunction>(
-        "push", [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          // 注意：这里我们需要修改数组，但方法是const的
-          // 我们需要const_cast来绕过这个限制
-          auto *mutableThis = const_cast<JArray *>(this);
-          for (const auto &arg : args) {
-            mutableThis->value_.push_back(arg);
-          }
-          return static_cast<uint32_t>(mutableThis->value_.size());
-        });
-    return pushFunc;
-  } else if (name == "pop") {
-    auto popFunc = std::make_shared<JFunction>(
-        "pop", [this](const std::vector<ValueVariant> &) -> ValueVariant {
-          auto *mutableThis = const_cast<JArray *>(this);
-          if (mutableThis->value_.empty())
-            return JUndefined{};
-          ValueVariant result = mutableThis->value_.back();
-          mutableThis->value_.pop_back();
-          return result;
-        });
-    return popFunc;
-  } else if (name == "shift") {
-    auto shiftFunc = std::make_shared<JFunction>(
-        "shift", [this](const std::vector<ValueVariant> &) -> ValueVariant {
-          auto *mutableThis = const_cast<JArray *>(this);
-          if (mutableThis->value_.empty())
-            return JUndefined{};
-          ValueVariant result = mutableThis->value_.front();
-          mutableThis->value_.erase(mutableThis->value_.begin());
-          return result;
-        });
-    return shiftFunc;
-  } else if (name == "unshift") {
-    auto unshiftFunc = std::make_shared<JFunction>(
-        "unshift",
-        [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          auto *mutableThis = const_cast<JArray *>(this);
-          mutableThis->value_.insert(mutableThis->value_.begin(), args.begin(),
-                                     args.end());
-          return static_cast<uint32_t>(mutableThis->value_.size());
-        });
-    return unshiftFunc;
-  } else if (name == "splice") {
-    auto spliceFunc = std::make_shared<JFunction>(
-        "splice",
-        [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          auto *mutableThis = const_cast<JArray *>(this);
-          if (args.empty())
-            return utils::createArray();
-
-          int32_t start = 0;
-          if (args.size() > 0 && std::holds_alternative<int32_t>(args[0])) {
-            start = std::get<int32_t>(args[0]);
-          }
-
-          size_t deleteCount = mutableThis->value_.size();
-          if (args.size() > 1 && std::holds_alternative<int32_t>(args[1])) {
-            deleteCount = std::max(0, std::get<int32_t>(args[1]));
-          }
-
-          if (start < 0)
-            start = std::max(
-                0, static_cast<int32_t>(mutableThis->value_.size()) + start);
-          size_t startIndex =
-              std::min(static_cast<size_t>(start), mutableThis->value_.size());
-          deleteCount =
-              std::min(deleteCount, mutableThis->value_.size() - startIndex);
-
-          // 创建被删除的元素数组
-          auto deletedArray = utils::createArray();
-          for (size_t i = 0; i < deleteCount; ++i) {
-            deletedArray->getValue().push_back(
-                mutableThis->value_[startIndex + i]);
-          }
-
-          // 删除元素
-          mutableThis->value_.erase(mutableThis->value_.begin() + startIndex,
-                                    mutableThis->value_.begin() + startIndex +
-                                        deleteCount);
-
-          // 插入新元素
-          if (args.size() > 2) {
-            mutableThis->value_.insert(mutableThis->value_.begin() + startIndex,
-                                       args.begin() + 2, args.end());
-          }
-
-          return deletedArray;
-        });
-    return spliceFunc;
-  } else if (name == "slice") {
-    auto sliceFunc = std::make_shared<JFunction>(
-        "slice", [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          int32_t start = 0;
-          int32_t end = static_cast<int32_t>(value_.size());
-
-          if (args.size() > 0 && std::holds_alternative<int32_t>(args[0])) {
-            start = std::get<int32_t>(args[0]);
-          }
-          if (args.size() > 1 && std::holds_alternative<int32_t>(args[1])) {
-            end = std::get<int32_t>(args[1]);
-          }
-
-          if (start < 0)
-            start = std::max(0, static_cast<int32_t>(value_.size()) + start);
-          if (end < 0)
-            end = std::max(0, static_cast<int32_t>(value_.size()) + end);
-
-          size_t startIndex =
-              std::min(static_cast<size_t>(start), value_.size());
-          size_t endIndex = std::min(static_cast<size_t>(end), value_.size());
-
-          if (startIndex >= endIndex)
-            return utils::createArray();
-
-          std::vector<ValueVariant> sliced(value_.begin() + startIndex,
-                                           value_.begin() + endIndex);
-          return std::make_shared<JArray>(sliced);
-        });
-    return sliceFunc;
-  }
-
-  // 调用父类方法处理通用属性
+    return At(index);
+  }
+  if (name == "length" && !findOwnProperty(name)) {
+    return static_cast<uint32_t>(elements_.size());
+  }
+
+  // 其余属性（含 Array.prototype 上的内置方法）交由父类处理
   return JObject::getPropertyInternal(name);
 }
 
+namespace {
+
+ValueVariant arrayPush(JObject &self, const std::vector<ValueVariant> &args) {
+  auto *array = dynamic_cast<JArray *>(&self);
+  if (!array)
+    return JUndefined{};
+  for (const auto &arg : args) {
+    array->Push(arg);
+  }
+  return static_cast<uint32_t>(array->Size());
+}
+
+ValueVariant arrayPop(JObject &self, const std::vector<ValueVariant> &) {
+  auto *array = dynamic_cast<JArray *>(&self);
+  if (!array)
+    return JUndefined{};
+  return array->Pop();
+}
+
+ValueVariant arrayShift(JObject &self, const std::vector<ValueVariant> &) {
+  auto *array = dynamic_cast<JArray *>(&self);
+  if (!array)
+    return JUndefined{};
+  return array->Shift();
+}
+
+ValueVariant arrayUnshift(JObject &self,
+                          const std::vector<ValueVariant> &args) {
+  auto *array = dynamic_cast<JArray *>(&self);
+  if (!array)
+    return JUndefined{};
+  array->Unshift(args.data(), args.size());
+  return static_cast<uint32_t>(array->Size());
+}
+
+ValueVariant arraySplice(JObject &self, const std::vector<ValueVariant> &args) {
+  auto *array = dynamic_cast<JArray *>(&self);
+  if (!array)
+    return JUndefined{};
+  if (args.empty())
+    return utils::createArray();
+  const size_t size = array->Size();
+
+  int32_t start = 0;
+  if (args.size() > 0 && std::holds_alternative<int32_t>(args[0])) {
+    start = std::get<int32_t>(args[0]);
+  }
+
+  size_t deleteCount = size;
+  if (args.size() > 1 && std::holds_alternative<int32_t>(args[1])) {
+    deleteCount = std::max(0, std::get<int32_t>(args[1]));
+  }
+
+  if (start < 0)
+    start = std::max(0, static_cast<int32_t>(size) + start);
+
+  const size_t itemCount = args.size() > 2 ? args.size() - 2 : 0;
+  return array->Splice(static_cast<size_t>(start), deleteCount,
+                       args.data() + args.size() - itemCount, itemCount);
+}
+
+ValueVariant arraySlice(JObject &self, const std::vector<ValueVariant> &args) {
+  auto *array = dynamic_cast<JArray *>(&self);
+  if (!array)
+    return JUndefined{};
+  const size_t size = array->Size();
+  int32_t start = 0;
+  int32_t end = static_cast<int32_t>(size);
+
+  if (args.size() > 0 && std::holds_alternative<int32_t>(args[0])) {
+    start = std::get<int32_t>(args[0]);
+  }
+  if (args.size() > 1 && std::holds_alternative<int32_t>(args[1])) {
+    end = std::get<int32_t>(args[1]);
+  }
+
+  if (start < 0)
+    start = std::max(0, static_cast<int32_t>(size) + start);
+  if (end < 0)
+    end = std::max(0, static_cast<int32_t>(size) + end);
+
+  return array->Slice(static_cast<size_t>(start), static_cast<size_t>(end));
+}
+
+} // namespace
+
+const Ref<JObject> &JArray::prototype() {
+  static constexpr BuiltinMethod kMethods[] = {
+      {"push", &arrayPush},
+      {"pop", &arrayPop},
+      {"shift", &arrayShift},
+      {"unshift", &arrayUnshift},
+      {"splice", &arraySplice},
+      {"slice", &arraySlice}};
+  static constexpr BuiltinTable kBuiltins(builtinNames(kMethods));
+  static const auto *proto =
+      makePrototype(JObject::prototype().get(), kMethods, kBuiltins);
+  return *proto;
+}
+
+const JObject *JArray::getPrototype() const { return prototype().get(); }
+
+bool JArray::interceptsProperty(const std::string &name) const {
+  size_t index = 0;
+  return name == "length" || tryParseArrayIndex(name, index);
+}
+
 // =======================
 // JFunction 实现
 // =======================
@@ -501,47 +1428,98 @@ JFunction::JFunction(const std::string &name, FunctionType func)
   initializeFunctionProperties();
 }
 
+JFunction::JFunction(const std::string &name, NativeMethod method,
+                     JObject *receiver)
+    : name_(name), method_(method), receiver_(receiver) {
+  initializeFunctionProperties();
+}
+
 void JFunction::initializeFunctionProperties() {
-  // name属性
-  jobject::utils::def_prop_ex(
-      *this, "name",
-      [this]() -> ValueVariant { return std::make_shared<JString>(name_); },
-      nullptr, false, false, true);
+  // name 与 length 在 getPropertyInternal 中按类型解析，
+  // call 方法由 Function.prototype 提供
+}
+
+namespace {
+
+bool isFunctionIntrinsic(const std::string &name) {
+  return name == "name" || name == "length";
+}
 
-  // length属性（参数个数，这里简化为0）
-  jobject::utils::def_prop_val(*this, "length", static_cast<uint32_t>(0), false,
-                               false, true);
+} // namespace
+
+bool JFunction::hasProperty(const std::string &name) const {
+  return isFunctionIntrinsic(name) || JObject::hasProperty(name);
+}
+
+bool JFunction::setProperty(const std::string &name,
+                            const ValueVariant &value) {
+  if (isFunctionIntrinsic(name) && !findOwnProperty(name)) {
+    return false; // 只读
+  }
+  return JObject::setProperty(name, value);
+}
 
-  // call方法将在getPropertyInternal中按需创建，避免递归
+ValueVariant JFunction::getPropertyInternal(const std::string &name) const {
+  if (isFunctionIntrinsic(name) && !findOwnProperty(name)) {
+    if (name == "name") {
+      return makeRef<JString>(name_);
+    }
+    return static_cast<uint32_t>(0); // 参数个数，这里简化为0
+  }
+  return JObject::getPropertyInternal(name);
+}
+
+bool JFunction::interceptsProperty(const std::string &name) const {
+  return isFunctionIntrinsic(name);
 }
 
 ValueVariant JFunction::Call(const std::vector<ValueVariant> &args) {
+  if (method_) {
+    // 未绑定的原生方法缺少 this，无法调用
+    return receiver_ ? method_(*receiver_, args) : ValueVariant{JUndefined{}};
+  }
   if (function_) {
     return function_(args);
   }
   return nullptr;
 }
 
+ValueVariant JFunction::Call(JObject &self,
+                             const std::vector<ValueVariant> &args) {
+  if (method_) {
+    return method_(self, args);
+  }
+  return Call(args);
+}
+
 std::string JFunction::toString() const {
   return "function " + name_ + "() { [native code] }";
 }
 
 void JFunction::setName(const std::string &name) { name_ = name; }
 
-ValueVariant JFunction::getPropertyInternal(const std::string &name) const {
-  // 处理JFunction特有的方法
-  if (name == "call") {
-    auto callFunc = std::make_shared<JFunction>(
-        "call", [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          return const_cast<JFunction *>(this)->Call(args);
-        });
-    return callFunc;
-  }
+namespace {
 
-  // 调用父类方法处理通用属性
-  return JObject::getPropertyInternal(name);
+ValueVariant functionCall(JObject &self,
+                          const std::vector<ValueVariant> &args) {
+  auto *function = dynamic_cast<JFunction *>(&self);
+  if (!function)
+    return JUndefined{};
+  return function->Call(args);
 }
 
+} // namespace
+
+const Ref<JObject> &JFunction::prototype() {
+  static constexpr BuiltinMethod kMethods[] = {{"call", &functionCall}};
+  static constexpr BuiltinTable kBuiltins(builtinNames(kMethods));
+  static const auto *proto =
+      makePrototype(JObject::prototype().get(), kMethods, kBuiltins);
+  return *proto;
+}
+
+const JObject *JFunction::getPrototype() const { return prototype().get(); }
+
 // =======================
 // JDate 实现
 // =======================
@@ -560,7 +1538,7 @@ JDate::JDate(int64_t timestamp)
 }
 
 void JDate::initializeDateProperties() {
-  // 日期方法将在getPropertyInternal中按需创建，避免递归
+  // 日期方法由 Date.prototype 提供
 }
 
 int64_t JDate::getTime() const {
@@ -580,33 +1558,41 @@ std::string JDate::toString() const {
   return ss.str();
 }
 
-ValueVariant JDate::getPropertyInternal(const std::string &name) const {
-  // 处理JDate特有的方法
-  if (name == "getTime") {
-    auto getTimeFunc = std::make_shared<JFunction>(
-        "getTime", [this](const std::vector<ValueVariant> &) -> ValueVariant {
-          return static_cast<uint64_t>(this->getTime());
-        });
-    return getTimeFunc;
-  } else if (name == "setTime") {
-    auto setTimeFunc = std::make_shared<JFunction>(
-        "setTime",
-        [this](const std::vector<ValueVariant> &args) -> ValueVariant {
-          auto *mutableThis = const_cast<JDate *>(this);
-          if (!args.empty()) {
-            if (std::holds_alternative<uint64_t>(args[0])) {
-              mutableThis->setTime(std::get<uint64_t>(args[0]));
-            } else if (std::holds_alternative<int32_t>(args[0])) {
-              mutableThis->setTime(std::get<int32_t>(args[0]));
-            }
-          }
-          return static_cast<uint64_t>(mutableThis->getTime());
-        });
-    return setTimeFunc;
-  }
-
-  // 调用父类方法处理通用属性
-  return JObject::getPropertyInternal(name);
+namespace {
+
+ValueVariant dateGetTime(JObject &self, const std::vector<ValueVariant> &) {
+  auto *date = dynamic_cast<JDate *>(&self);
+  if (!date)
+    return JUndefined{};
+  return static_cast<uint64_t>(date->getTime());
 }
 
+ValueVariant dateSetTime(JObject &self,
+                         const std::vector<ValueVariant> &args) {
+  auto *date = dynamic_cast<JDate *>(&self);
+  if (!date)
+    return JUndefined{};
+  if (!args.empty()) {
+    if (std::holds_alternative<uint64_t>(args[0])) {
+      date->setTime(std::get<uint64_t>(args[0]));
+    } else if (std::holds_alternative<int32_t>(args[0])) {
+      date->setTime(std::get<int32_t>(args[0]));
+    }
+  }
+  return static_cast<uint64_t>(date->getTime());
+}
+
+} // namespace
+
+const Ref<JObject> &JDate::prototype() {
+  static constexpr BuiltinMethod kMethods[] = {{"getTime", &dateGetTime},
+                                               {"setTime", &dateSetTime}};
+  static constexpr BuiltinTable kBuiltins(builtinNames(kMethods));
+  static const auto *proto =
+      makePrototype(JObject::prototype().get(), kMethods, kBuiltins);
+  return *proto;
+}
+
+const JObject *JDate::getPrototype() const { return prototype().get(); }
+
 } // namespace jobject
@@ -1,80 +1,35 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
-#include <unordered_map>
-#include <variant>
+#include <string_view>
 #include <vector>
 
-namespace jobject {
-
-// 前向声明
-class JObject;
-class JString;
-class JArray;
-class JFunction;
-class JDate;
-class jvalue;
-
-// undefined 标签类型（零开销空结构体，区分 JS 的 undefined 与 null）
-struct JUndefined {
-  bool operator==(const JUndefined &) const { return true; }
-};
+#include "Atom.h"
+#include "CompactValue.h"
+#include "Dictionary.h"
+#include "Elements.h"
+#include "Property.h"
+#include "Shape.h"
+#include "Utf8.h"
+#include "Value.h"
 
-// 全局 undefined 常量（可写 jobject::undefined）
-inline constexpr JUndefined undefined{};
-
-// 值类型枚举
-enum class ValueType {
-  Undefined,
-  Null,
-  Boolean,
-  Int32,
-  UInt32,
-  UInt64,
-  Double,
-  String,
-  Array,
-  Object,
-  Function,
-  Date
-};
+namespace jobject {
 
-// 值的变体类型
-using ValueVariant = std::variant<JUndefined,               // Undefined
-                                  std::nullptr_t,           // Null
-                                  bool,                     // Boolean
-                                  int32_t,                  // Int32
-                                  uint32_t,                 // UInt32
-                                  uint64_t,                 // UInt64
-                                  double,                   // Double
-                                  std::shared_ptr<JString>, // String
-                                  std::shared_ptr<JArray>,  // Array
-
-                                  std::shared_ptr<JObject>,   // Object
-                                  std::shared_ptr<JFunction>, // Function
-                                  std::shared_ptr<JDate>      // Date
-                                  >;
-
-// 属性描述符
-struct PropertyDescriptor {
-  ValueVariant value;
-  bool writable = true;
-  bool enumerable = true;
-  bool configurable = true;
-  std::function<ValueVariant()> getter = nullptr;
-  std::function<void(const ValueVariant &)> setter = nullptr;
-};
+// 原生方法：由原型对象共享，调用时显式接收 this
+using NativeMethod = ValueVariant (*)(JObject &self,
+                                      const std::vector<ValueVariant> &args);
 
-// 基础对象类
-class JObject {
+// 基础对象类；以 Ref<T> 侵入式引用计数管理生命周期
+class JObject : public RefCounted {
 public:
   JObject();
-  virtual ~JObject() = default;
+  virtual ~JObject();
 
   // 属性管理
   virtual bool defineProperty(const std::string &name,
@@ -83,17 +38,39 @@ public:
   virtual bool hasProperty(const std::string &name) const;
   virtual std::vector<std::string> getPropertyNames() const;
 
+  // 按插入顺序访问可枚举的自有命名属性，
+  // 属性名以引用传出、不复制。visitor 中不得修改该对象的属性。
+  void forEachProperty(
+      const std::function<void(const std::string &, const ValueVariant &)>
+          &visitor) const;
+
   // 属性访问
   virtual ValueVariant getProperty(const std::string &name) const;
   virtual bool setProperty(const std::string &name, const ValueVariant &value);
 
+  // 以原子为键的快速路径：自有属性按预计算哈希与整数比较查找，
+  // 数组下标原子及查找失败的情况交由上面的字符串接口处理。
+  bool defineProperty(Atom name, const PropertyDescriptor &descriptor);
+  bool deleteProperty(Atom name);
+  bool hasProperty(Atom name) const;
+  ValueVariant getProperty(Atom name) const;
+  bool setProperty(Atom name, const ValueVariant &value);
+
   // 设置属性的辅助方法
   void setPropertyValue(const std::string &name, const ValueVariant &value);
   void setPropertyValue(size_t index, const ValueVariant &value);
 
-  // 属性枚举顺序
+  // 属性总是按插入顺序枚举（快速模式由 Shape 记录顺序，字典模式使用
+  // 有序字典），保留该接口仅为兼容，设置不再影响行为
   void keepOrder(bool enable);
 
+  // 预留 count 个新属性的存储空间。总数超过 Shape::kMaxProperties 时
+  // 直接转为字典模式，批量构建大对象时不必逐个经过转移树。
+  void reserveProperties(size_t count);
+
+  // 当前隐藏类；对象处于字典模式时为空
+  const std::shared_ptr<const Shape> &shape() const { return shape_; }
+
   // 数据上下文
   void *data = nullptr;
 
@@ -101,46 +78,244 @@ public:
   virtual ValueType getType() const { return ValueType::Object; }
   virtual std::string toString() const;
 
+  // 原型链：自有属性查找失败后依次在原型对象上查找。
+  // 各类型的原型为全局共享对象，内置方法只在原型上创建一次。
+  static const Ref<JObject> &prototype(); // Object.prototype
+  virtual const JObject *getPrototype() const;
+
 protected:
-  std::unordered_map<std::string, PropertyDescriptor> properties_;
-  std::vector<std::string> insertionOrder_;
-  bool keepOrder_ = false;
+  // 快速模式：属性键与槽位下标由共享的 shape_ 描述，对象只保存 slots_，
+  // 前几个槽位内联在对象中。
+  // 删除非末尾属性或属性数超过 Shape::kMaxProperties 后转为字典模式，
+  // 此时 shape_ 为空，属性存放在有序字典 dictionary_ 中。
+  std::shared_ptr<const Shape> shape_;
+  SlotStorage slots_;
+  std::unique_ptr<PropertyDictionary> dictionary_;
   void initializeCommonProperties();
 
+  // 查找自有属性描述符，不存在时返回 nullptr
+  PropertySlot *findOwnProperty(const std::string &name);
+  const PropertySlot *findOwnProperty(const std::string &name) const;
+  PropertySlot *findOwnProperty(Atom name);
+  const PropertySlot *findOwnProperty(Atom name) const;
+
+  void appendSlot(Atom name, PropertySlot slot);
+  bool popLastSlot(uint32_t slot);
+  void addDictionaryProperty(const std::string &name, PropertySlot slot);
+  bool eraseDictionaryProperty(const std::string &name);
+  void convertToDictionaryMode();
+
+  // 按槽位读取快速模式下的自有属性，slot 必须来自当前 shape_
+  ValueVariant getSlotValue(uint32_t slot) const;
+
+  // 以已知的 shape 一次性建立全部自有属性（普通数据属性），values 依次对应
+  // shape 的各个槽位。只能用于尚无自有属性的对象，跳过逐个属性的转移查找。
+  void initializeSlots(std::shared_ptr<const Shape> shape,
+                       const ValueVariant *values);
+
+  // 作为原型被查找时的自有属性查找。hash 为 hashBuiltinName(name)，
+  // 沿原型链查找时只计算一次；原型对象据此按内置名完美哈希表定位内置方法
+  virtual const PropertySlot *findPrototypeProperty(const std::string &name,
+                                                    uint64_t hash) const;
+
+  // 从原型链取得的内置方法按接收者绑定后缓存，重复读取同一方法不再分配。
+  // 可在多个线程并发读取同一对象时调用
+  ValueVariant bindMethod(const ValueVariant &value) const;
+
+  // 缓存为只在头部插入的链表：读取者无锁遍历，插入由全局锁串行化，
+  // 节点发布后不再修改，随对象一起释放
+  struct BoundMethod {
+    NativeMethod method;
+    Ref<JFunction> bound;
+    std::unique_ptr<BoundMethod> next;
+  };
+  mutable std::atomic<BoundMethod *> boundMethods_{nullptr};
+
 protected:
   // 内部属性访问辅助方法，子类可以重写来处理特有的属性
   virtual ValueVariant getPropertyInternal(const std::string &name) const;
+
+  // 子类在查找自有属性之前拦截的属性名（如数组索引）以及按类型解析的
+  // 内在属性（如 length）需返回 true。内联缓存不会缓存这些属性，
+  // 按原子写入时也会改走虚的 setProperty，以免绕过子类的拦截逻辑
+  virtual bool interceptsProperty(const std::string &name) const;
+
+  friend class utils::CompiledPath;
+  friend class utils::JSONParser;
 };
 
 // 字符串类
 class JString : public JObject {
 public:
-  JString(const std::string &str = "");
+  JString(std::string str = "");
   JString(const char *str);
+  ~JString() override;
 
   // C++方法
   size_t Size() const;
   bool Empty() const;
-  void Clear();
+  // 驻留字符串不可修改：Clear 与 setValue 返回 false，内容不变
+  bool Clear();
   char At(size_t index) const;
   char Front() const;
   char Back() const;
+  // 依次拼接 values 的字符串形式。结果较长时不复制内容，只记录各段
+  // （rope），首次读取内容时再展平
+  Ref<JString> Concat(const ValueVariant *values, size_t count) const;
+  // 查找子串的字节偏移，没有时返回 std::string_view::npos
+  size_t IndexOf(std::string_view needle, size_t from = 0) const;
+  size_t LastIndexOf(std::string_view needle,
+                     size_t from = std::string_view::npos) const;
+  // 字节区间 [begin, end) 的子串，越界部分被截断。较长的子串不复制内容，
+  // 与原字符串共享字节
+  Ref<JString> Substring(size_t begin, size_t end) const;
+  // 按 separator 切分；separator 为空时逐码点切分。各段以子串共享字节
+  Ref<JArray> Split(std::string_view separator,
+                    size_t limit = SIZE_MAX) const;
+
+  // Unicode 访问。Size、At、Substring 等按 UTF-8 字节计，下列方法按码点或
+  // UTF-16 单元计（后者与 JavaScript 的 length 和下标一致）。纯 ASCII 字符串
+  // 直接按字节处理，其他字符串首次使用时建立一次路标索引（Utf8Index）。
+  // 非法的 UTF-8 字节各按一个 U+FFFD 计
+  bool IsAscii() const;
+  size_t CodePointLength() const;
+  // 越界时返回 0
+  uint32_t CodePointAt(size_t index) const;
+  size_t Utf16Length() const;
+  // 越界时返回 0；补充平面的码点按代理对中的高位或低位单元返回
+  char16_t Utf16At(size_t index) const;
+  // UTF-16 偏移与字节偏移互相转换，超出末尾时截断到末尾。
+  // 落在代理对中间的 UTF-16 偏移按该码点的起始位置处理
+  size_t Utf16ToByteOffset(size_t unit) const;
+  size_t ByteToUtf16Offset(size_t byte) const;
+
+  // 内容哈希，首次使用时计算并缓存，内容修改后重新计算
+  size_t Hash() const {
+    const size_t hash = hash_.load(std::memory_order_relaxed);
+    return hash != 0 ? hash : computeHash();
+  }
+  // 内容是否相同。两个驻留字符串只比较指针；长度不同或已缓存的哈希
+  // 不同时不比较内容
+  bool Equals(const JString &other) const;
 
   // 重写基类方法
   ValueType getType() const override { return ValueType::String; }
   std::string toString() const override;
 
-  // 获取底层字符串
-  const std::string &getValue() const { return value_; }
-  void setValue(const std::string &value);
+  // 获取底层字符串；拼接得到的字符串在此展平，子串在此复制出自己的
+  // 内容，结果均被缓存
+  const std::string &getValue() const {
+    if (rope_ || slice_) {
+      return indirectValue();
+    }
+    return value_;
+  }
+  // 字符串内容的只读视图；子串直接指向共享的字节，不复制。
+  // 视图在字符串释放或修改前有效
+  std::string_view view() const {
+    if (slice_) {
+      return std::string_view(slice_->text.data, slice_->text.length);
+    }
+    return getValue();
+  }
+  bool setValue(const std::string &value);
+
+  // length（UTF-16 单元数）按类型解析，不占用实例属性；同名自有属性优先
+  using JObject::hasProperty;
+  using JObject::setProperty;
+  bool hasProperty(const std::string &name) const override;
+  bool setProperty(const std::string &name,
+                   const ValueVariant &value) override;
+
+  // String.prototype：concat、indexOf、lastIndexOf、substring、slice、split、
+  // charAt、charCodeAt、codePointAt。下标与 length 一样按 UTF-16 单元计
+  static const Ref<JObject> &prototype();
+  const JObject *getPrototype() const override;
 
 protected:
-  // 重写属性访问方法以处理字符串特有的方法
   ValueVariant getPropertyInternal(const std::string &name) const override;
+  bool interceptsProperty(const std::string &name) const override;
 
 private:
-  std::string value_;
+  // 被子串或拼接链共享的字节。字符串在修改或释放前把仍被共享的内容移交到
+  // bytes（被共享的内容不短于 kMinSharedSubstring，位于堆上，移动
+  // std::string 不改变字节地址），各引用者的指针因此始终有效；最后一个
+  // 引用释放时字节随之释放。size 为共享时整段内容的字节数
+  struct SharedBytes : RefCounted {
+    std::string bytes;
+    size_t size = 0;
+  };
+
+  // 不可变的一段字节 [data, data + length)，由 bytes 保证存活
+  struct Segment {
+    Ref<SharedBytes> bytes;
+    const char *data = nullptr;
+    size_t length = 0;
+  };
+
+  // 拼接链节点，创建后不可变，可被多个拼接结果共享。每段为一个子节点
+  // 或一段字节；各段在拼接时取得快照，之后修改参与拼接的字符串不影响结果
+  struct RopeNode : RefCounted {
+    struct Piece {
+      Ref<RopeNode> node;
+      Segment text;
+    };
+    std::vector<Piece> pieces;
+    // 逐层释放，长链析构不递归
+    ~RopeNode();
+  };
+
+  // 拼接结果：内容为 node 的各段依次相接，展平后 node 被释放。
+  // length 在创建时确定，读取长度不需要展平
+  struct Rope {
+    Ref<RopeNode> node;
+    size_t length = 0;
+    std::atomic<bool> flat{false};
+  };
+
+  // 子串：内容为 text；子串的子串直接共享同一段字节，不会形成链
+  struct Slice {
+    Segment text;
+    std::atomic<bool> copied{false}; // value_ 已缓存内容
+  };
+
+  enum class Charset : uint8_t { Unknown, Ascii, NonAscii };
+
   void initializeStringProperties();
+  const std::string &indirectValue() const;
+  // 非 ASCII 字符串的路标索引，首次使用时建立
+  const Utf8Index &utf8Index() const;
+  void flatten() const;
+  // 当前内容的共享快照；短内容（不足 kMinSharedSubstring）追加到 run，
+  // 否则先把 run 作为一段放入 pieces 再放入本字符串的共享段
+  void appendPieces(std::vector<RopeNode::Piece> &pieces,
+                    std::string &run) const;
+  // 本字符串内容（不足 kMinSharedSubstring 时不应调用）的共享段；
+  // 调用方须持有 contentMutex
+  Segment sharedSegment() const;
+  // 仍被共享的字节移交给 SharedBytes，本字符串不再引用它
+  void detachShared();
+  // 修改内容前调用：释放拼接链与子串，移交被共享的字节
+  void releaseContent();
+  size_t computeHash() const;
+  // 0 保留为“尚未计算”
+  static size_t hashOf(std::string_view text);
+
+  mutable std::string value_;
+  std::unique_ptr<Rope> rope_;
+  std::unique_ptr<Slice> slice_;
+  // value_ 被子串或拼接链共享时，修改或释放前接收其字节；
+  // 首次共享时在 contentMutex 下创建
+  mutable Ref<SharedBytes> shared_;
+  mutable std::atomic<const Utf8Index *> index_{nullptr};
+  // 是否为纯 ASCII；构造时检测，拼接与子串尽量由各段推出，否则首次使用时检测
+  mutable std::atomic<Charset> charset_{Charset::Unknown};
+  // 内容哈希，0 表示尚未计算；并发计算得到相同结果
+  mutable std::atomic<size_t> hash_{0};
+  // 是否登记在驻留表中；驻留字符串不可修改，析构时从表中移除
+  bool interned_ = false;
+
+  friend class StringTable;
 };
 
 // 数组类
@@ -148,13 +323,26 @@ class JArray : public JObject {
 public:
   JArray(size_t size = 0);
   JArray(const std::vector<ValueVariant> &values);
+  JArray(const ValueVariant *values, size_t count);
 
   // C++方法
+  // Size 为数组长度；稀疏数组中并非每个下标都存在，空位读取为 undefined
   size_t Size() const;
   bool Empty() const;
+  // 下标 index 处是否存在元素
+  bool Has(size_t index) const;
+  // 不小于 from 的第一个存在元素的下标，没有时返回 Size()
+  size_t NextIndex(size_t from) const;
   void Clear();
   void Push(const ValueVariant &value);
   ValueVariant Pop();
+  ValueVariant Shift();
+  void Unshift(const ValueVariant *values, size_t count);
+  // 从 start 起删除 deleteCount 个元素并插入 items，返回被删除的元素
+  Ref<JArray> Splice(size_t start, size_t deleteCount,
+                                 const ValueVariant *items, size_t count);
+  // 返回 [begin, end) 范围元素组成的新数组
+  Ref<JArray> Slice(size_t begin, size_t end) const;
   ValueVariant At(size_t index) const;
   ValueVariant Front() const;
   ValueVariant Back() const;
@@ -163,25 +351,40 @@ public:
   ValueType getType() const override { return ValueType::Array; }
   std::string toString() const override;
 
-  // 重写属性管理方法，数字索引按需动态解析，避免维护索引属性描述符
+  // 重写属性管理方法，数字索引与 length 按需动态解析，避免维护属性描述符
+  using JObject::hasProperty;
+  using JObject::setProperty;
   bool hasProperty(const std::string &name) const override;
   std::vector<std::string> getPropertyNames() const override;
   bool setProperty(const std::string &name,
                    const ValueVariant &value) override;
 
-  // 数组特有的属性访问
+  // 数组特有的属性访问。index 超过 kMaxArrayIndex 时按普通属性保存
   void setElement(size_t index, const ValueVariant &value);
 
-  // 获取底层数组
-  const std::vector<ValueVariant> &getValue() const { return value_; }
-  std::vector<ValueVariant> &getValue() { return value_; }
+  // 复制出全部元素，空位为 undefined
+  std::vector<ValueVariant> toVector() const;
+
+  // 元素种类；同构的数值数组可通过 packedData 直接访问连续的原始数据，
+  // 种类与 T 不一致时返回 nullptr
+  ElementsKind elementsKind() const { return elements_.kind(); }
+  template <typename T> const T *packedData() const {
+    return elements_.packedData<T>();
+  }
+
+  // Array.prototype：push、pop、shift、unshift、splice、slice
+  static const Ref<JObject> &prototype();
+  const JObject *getPrototype() const override;
 
 protected:
-  // 重写属性访问方法以处理数组特有的方法
+  // 重写属性访问方法以处理数字索引
   ValueVariant getPropertyInternal(const std::string &name) const override;
+  bool interceptsProperty(const std::string &name) const override;
 
 private:
-  std::vector<ValueVariant> value_;
+  // 同构的 int32/double/uint64 元素紧密保存，其余情况以 CompactValue 保存，
+  // 空位很多时只保存存在的元素
+  Elements elements_;
   void initializeArrayProperties();
 };
 
@@ -192,9 +395,17 @@ public:
       std::function<ValueVariant(const std::vector<ValueVariant> &)>;
 
   JFunction(const std::string &name = "", FunctionType func = nullptr);
+  // 原生方法；receiver 非空时为绑定到该接收者的方法
+  JFunction(const std::string &name, NativeMethod method, JObject *receiver);
 
   // C++方法
   ValueVariant Call(const std::vector<ValueVariant> &args);
+  // 以 self 作为 this 调用（普通函数忽略 self）
+  ValueVariant Call(JObject &self, const std::vector<ValueVariant> &args);
+
+  // 未绑定接收者的原生方法，从原型链读取时需要绑定
+  bool isUnboundMethod() const { return method_ && !receiver_; }
+  NativeMethod getMethod() const { return method_; }
 
   // 重写基类方法
   ValueType getType() const override { return ValueType::Function; }
@@ -204,13 +415,26 @@ public:
   const std::string &getName() const { return name_; }
   void setName(const std::string &name);
 
+  // name 与 length 按类型解析，不占用实例属性；同名自有属性优先
+  using JObject::hasProperty;
+  using JObject::setProperty;
+  bool hasProperty(const std::string &name) const override;
+  bool setProperty(const std::string &name,
+                   const ValueVariant &value) override;
+
+  // Function.prototype：call
+  static const Ref<JObject> &prototype();
+  const JObject *getPrototype() const override;
+
 protected:
-  // 重写属性访问方法以处理函数特有的方法
   ValueVariant getPropertyInternal(const std::string &name) const override;
+  bool interceptsProperty(const std::string &name) const override;
 
 private:
   std::string name_;
   FunctionType function_;
+  NativeMethod method_ = nullptr;
+  JObject *receiver_ = nullptr;
   void initializeFunctionProperties();
 };
 
@@ -229,9 +453,9 @@ public:
   int64_t getTime() const; // 获取毫秒时间戳
   void setTime(int64_t timestamp);
 
-protected:
-  // 重写属性访问方法以处理日期特有的方法
-  ValueVariant getPropertyInternal(const std::string &name) const override;
+  // Date.prototype：getTime、setTime
+  static const Ref<JObject> &prototype();
+  const JObject *getPrototype() const override;
 
 private:
   std::chrono::system_clock::time_point time_;
@@ -240,7 +464,9 @@ private:
 
 } // namespace jobject
 
-// 访问器（jvalue/jarray/jstring）与工具函数（utils）从独立头文件提供，
-// 在此包含以保持对 "JObject.h" 的向后兼容。
+// 访问器（jvalue/jarray/jstring）、工具函数（utils）与 JSON 解析从独立头文件
+// 提供，在此包含以保持对 "JObject.h" 的向后兼容。
 #include "Accessor.h"
+#include "Json.h"
+#include "StringSearch.h"
 #include "Utils.h"
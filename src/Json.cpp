@@ -0,0 +1,841 @@
+#include "Json.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JOBJECT_JSON_SSE2 1
+#endif
+
+namespace jobject {
+
+namespace {
+
+constexpr size_t kMaxDepth = 1024;
+
+#ifdef JOBJECT_JSON_SSE2
+inline unsigned countTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+inline bool isWhitespace(char ch) {
+  return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+// 字符串内容中需要特殊处理的字节：引号、反斜杠与控制字符
+inline bool isStringSpecial(char ch) {
+  return ch == '"' || ch == '\\' || static_cast<unsigned char>(ch) < 0x20;
+}
+
+/**
+ * @brief Find the first quote, backslash or control byte in [p, end).
+ *
+ * Scans 16 bytes per step with SSE2 where available, so long string
+ * contents without escapes are consumed in a handful of instructions.
+ *
+ * @return Pointer to the first special byte, or end if there is none.
+ */
+const char *scanStringSpecial(const char *p, const char *end) {
+#ifdef JOBJECT_JSON_SSE2
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1F);
+  while (end - p >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    // 无符号 min(chunk, 0x1F) == chunk 即 chunk <= 0x1F
+    const __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                     _mm_cmpeq_epi8(chunk, backslash)),
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    if (mask) {
+      return p + countTrailingZeros(mask);
+    }
+    p += 16;
+  }
+#endif
+  while (p < end && !isStringSpecial(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+// 跳过空白；格式化输出中的长缩进按 16 字节一组跳过
+const char *skipWhitespace(const char *p, const char *end) {
+  if (p == end || !isWhitespace(*p)) {
+    return p;
+  }
+#ifdef JOBJECT_JSON_SSE2
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i carriage = _mm_set1_epi8('\r');
+  const __m128i tab = _mm_set1_epi8('\t');
+  while (end - p >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i blank = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                     _mm_cmpeq_epi8(chunk, newline)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage),
+                     _mm_cmpeq_epi8(chunk, tab)));
+    const unsigned mask =
+        ~static_cast<unsigned>(_mm_movemask_epi8(blank)) & 0xFFFFu;
+    if (mask) {
+      return p + countTrailingZeros(mask);
+    }
+    p += 16;
+  }
+#endif
+  while (p < end && isWhitespace(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+int hexValue(char ch) {
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  return -1;
+}
+
+} // namespace
+
+namespace utils {
+
+// 递归下降解析器。容器的子值先压入共享的 values_ 栈，容器闭合时元素数量
+// 已知，数组一次性按数量构造，对象先按数量预留属性存储再逐个写入，
+// 避免逐个追加时的反复扩容。
+//
+// 文档中的对象大多是同构记录：最近得到的 Shape 按首个键缓存，下一个键序列
+// 相同的对象直接以该 Shape 建立槽位，不再逐个属性经过全局转移树。
+class JSONParser {
+public:
+  explicit JSONParser(std::string_view json,
+                      const JSONParseOptions &options = JSONParseOptions())
+      : begin_(json.data()), p_(json.data()), end_(json.data() + json.size()),
+        internStrings_(options.internStrings) {}
+
+  ValueVariant parseDocument() {
+    p_ = skipWhitespace(p_, end_);
+    ValueVariant root = parseValue(0);
+    p_ = skipWhitespace(p_, end_);
+    if (p_ != end_) {
+      fail("unexpected trailing characters");
+    }
+    return root;
+  }
+
+private:
+  [[noreturn]] void fail(const char *message) const {
+    throw JSONParseError(message, static_cast<size_t>(p_ - begin_));
+  }
+
+  void expect(char ch, const char *message) {
+    if (p_ == end_ || *p_ != ch) {
+      fail(message);
+    }
+    ++p_;
+  }
+
+  // 调用前 p_ 指向值的第一个字符（已跳过空白）
+  ValueVariant parseValue(size_t depth) {
+    if (p_ == end_) {
+      fail("unexpected end of input");
+    }
+    switch (*p_) {
+    case '{':
+      return parseObject(depth + 1);
+    case '[':
+      return parseArray(depth + 1);
+    case '"':
+      parseString();
+      if (internStrings_) {
+        return internString(scratch_);
+      }
+      return makeRef<JString>(scratch_);
+    case 't':
+      parseLiteral("true", 4);
+      return true;
+    case 'f':
+      parseLiteral("false", 5);
+      return false;
+    case 'n':
+      parseLiteral("null", 4);
+      return nullptr;
+    default:
+      return parseNumber();
+    }
+  }
+
+  void parseLiteral(const char *literal, size_t length) {
+    if (static_cast<size_t>(end_ - p_) < length ||
+        std::memcmp(p_, literal, length) != 0) {
+      fail("invalid literal");
+    }
+    p_ += length;
+  }
+
+  ValueVariant parseArray(size_t depth) {
+    if (depth > kMaxDepth) {
+      fail("nesting too deep");
+    }
+    ++p_; // '['
+    const size_t base = values_.size();
+    p_ = skipWhitespace(p_, end_);
+    if (p_ != end_ && *p_ == ']') {
+      ++p_;
+      return makeRef<JArray>();
+    }
+    while (true) {
+      values_.push_back(parseValue(depth));
+      p_ = skipWhitespace(p_, end_);
+      if (p_ != end_ && *p_ == ',') {
+        p_ = skipWhitespace(p_ + 1, end_);
+        continue;
+      }
+      expect(']', "expected ',' or ']'");
+      break;
+    }
+    auto array = makeRef<JArray>(values_.data() + base, values_.size() - base);
+    values_.resize(base);
+    return array;
+  }
+
+  ValueVariant parseObject(size_t depth) {
+    if (depth > kMaxDepth) {
+      fail("nesting too deep");
+    }
+    ++p_; // '{'
+    const size_t base = values_.size();
+    p_ = skipWhitespace(p_, end_);
+    if (p_ != end_ && *p_ == '}') {
+      ++p_;
+      return makeRef<JObject>();
+    }
+    while (true) {
+      if (p_ == end_ || *p_ != '"') {
+        fail("expected property name");
+      }
+      parseString();
+      keys_.push_back(scratch_);
+      p_ = skipWhitespace(p_, end_);
+      expect(':', "expected ':'");
+      p_ = skipWhitespace(p_, end_);
+      values_.push_back(parseValue(depth));
+      p_ = skipWhitespace(p_, end_);
+      if (p_ != end_ && *p_ == ',') {
+        p_ = skipWhitespace(p_ + 1, end_);
+        continue;
+      }
+      expect('}', "expected ',' or '}'");
+      break;
+    }
+    const size_t count = values_.size() - base;
+    const size_t keyBase = keys_.size() - count;
+    auto object = makeRef<JObject>();
+    if (count <= Shape::kMaxProperties) {
+      buildFastObject(*object, keys_.data() + keyBase, values_.data() + base,
+                      count);
+    } else {
+      // 超出快速模式上限的大对象（如以 ID 为键的映射）直接进入字典模式，
+      // 其键不驻留为原子
+      object->reserveProperties(count);
+      for (size_t i = 0; i < count; ++i) {
+        object->setProperty(keys_[keyBase + i], values_[base + i]);
+      }
+    }
+    values_.resize(base);
+    keys_.resize(keyBase);
+    return object;
+  }
+
+  void buildFastObject(JObject &object, const std::string *keys,
+                       const ValueVariant *values, size_t count) {
+    atoms_.clear();
+    for (size_t i = 0; i < count; ++i) {
+      atoms_.push_back(internKey(keys[i]));
+    }
+
+    auto &cached = shapeCache_[atoms_[0].id() & (kShapeCacheSize - 1)];
+    if (cached && cached->propertyCount() == count) {
+      bool match = true;
+      for (size_t i = 0; i < count && match; ++i) {
+        match = cached->keyAt(i) == atoms_[i];
+      }
+      if (match) {
+        object.initializeSlots(cached, values);
+        return;
+      }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      object.setProperty(atoms_[i], values[i]);
+    }
+    // 含重复键的对象最终 Shape 与键序列不一致，不会命中缓存
+    if (object.shape()) {
+      cached = object.shape();
+    }
+  }
+
+  // 直接映射的原子缓存：命中时只需比较哈希与内容，不访问原子表的锁
+  Atom internKey(const std::string &key) {
+    const size_t hash = hashPropertyName(key);
+    Atom &entry = atomCache_[hash & (kAtomCacheSize - 1)];
+    if (!entry.valid() || entry.hash() != hash || entry.str() != key) {
+      entry = Atom::intern(key);
+    }
+    return entry;
+  }
+
+  // 解析字符串到 scratch_，调用前 p_ 指向起始引号
+  void parseString() {
+    ++p_; // '"'
+    scratch_.clear();
+    while (true) {
+      const char *special = scanStringSpecial(p_, end_);
+      scratch_.append(p_, special);
+      p_ = special;
+      if (p_ == end_) {
+        fail("unterminated string");
+      }
+      if (*p_ == '"') {
+        ++p_;
+        return;
+      }
+      if (*p_ != '\\') {
+        fail("control character in string");
+      }
+      parseEscape();
+    }
+  }
+
+  void parseEscape() {
+    ++p_; // '\\'
+    if (p_ == end_) {
+      fail("unterminated string");
+    }
+    const char ch = *p_++;
+    switch (ch) {
+    case '"':
+    case '\\':
+    case '/':
+      scratch_.push_back(ch);
+      return;
+    case 'b':
+      scratch_.push_back('\b');
+      return;
+    case 'f':
+      scratch_.push_back('\f');
+      return;
+    case 'n':
+      scratch_.push_back('\n');
+      return;
+    case 'r':
+      scratch_.push_back('\r');
+      return;
+    case 't':
+      scratch_.push_back('\t');
+      return;
+    case 'u':
+      break;
+    default:
+      --p_;
+      fail("invalid escape sequence");
+    }
+
+    uint32_t codePoint = parseHex4();
+    if (codePoint >= 0xD800 && codePoint <= 0xDBFF && end_ - p_ >= 6 &&
+        p_[0] == '\\' && p_[1] == 'u') {
+      const char *saved = p_;
+      p_ += 2;
+      const uint32_t low = parseHex4();
+      if (low >= 0xDC00 && low <= 0xDFFF) {
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+      } else {
+        p_ = saved;
+      }
+    }
+    // 不成对的代理项无法编码为 UTF-8，以替换字符代替
+    if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+      codePoint = 0xFFFD;
+    }
+    appendUtf8(scratch_, codePoint);
+  }
+
+  uint32_t parseHex4() {
+    if (end_ - p_ < 4) {
+      fail("invalid unicode escape");
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+      const int digit = hexValue(p_[i]);
+      if (digit < 0) {
+        fail("invalid unicode escape");
+      }
+      value = (value << 4) | static_cast<uint32_t>(digit);
+    }
+    p_ += 4;
+    return value;
+  }
+
+  ValueVariant parseNumber() {
+    const char *start = p_;
+    const bool negative = *p_ == '-';
+    if (negative) {
+      ++p_;
+    }
+
+    // 整数部分：0 或不以 0 开头的数字串；19 位以内直接累加
+    const char *digits = p_;
+    uint64_t magnitude = 0;
+    while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+      magnitude = magnitude * 10 + static_cast<uint64_t>(*p_ - '0');
+      ++p_;
+    }
+    const size_t digitCount = static_cast<size_t>(p_ - digits);
+    if (digitCount == 0 || (*digits == '0' && digitCount > 1)) {
+      p_ = start;
+      fail("invalid number");
+    }
+
+    bool integral = true;
+    if (p_ < end_ && *p_ == '.') {
+      integral = false;
+      ++p_;
+      if (!skipDigits()) {
+        fail("invalid number");
+      }
+    }
+    if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+      integral = false;
+      ++p_;
+      if (p_ < end_ && (*p_ == '+' || *p_ == '-')) {
+        ++p_;
+      }
+      if (!skipDigits()) {
+        fail("invalid number");
+      }
+    }
+
+    if (integral && digitCount <= 19) {
+      if (!negative) {
+        if (magnitude <= static_cast<uint64_t>(INT32_MAX)) {
+          return static_cast<int32_t>(magnitude);
+        }
+        if (magnitude <= UINT32_MAX) {
+          return static_cast<uint32_t>(magnitude);
+        }
+        return magnitude;
+      }
+      if (magnitude != 0 &&
+          magnitude <= static_cast<uint64_t>(INT32_MAX) + 1) {
+        return static_cast<int32_t>(-static_cast<int64_t>(magnitude));
+      }
+    } else if (integral && digitCount == 20 && !negative) {
+      // 20 位数字可能仍在 uint64 范围内，按字符重新解析以检测溢出
+      uint64_t value = 0;
+      const auto result = std::from_chars(digits, p_, value);
+      if (result.ec == std::errc()) {
+        return value;
+      }
+    }
+
+    double value = 0;
+    const auto result = std::from_chars(start, p_, value);
+    if (result.ec == std::errc::result_out_of_range) {
+      // 超出 double 范围的字面量按 JS 语义取 ±Infinity 或 ±0
+      const bool underflow = [&] {
+        for (const char *q = start; q < p_; ++q) {
+          if (*q == 'e' || *q == 'E') {
+            return q[1] == '-';
+          }
+        }
+        return false;
+      }();
+      const double limit =
+          underflow ? 0.0 : std::numeric_limits<double>::infinity();
+      return negative ? -limit : limit;
+    }
+    return value;
+  }
+
+  bool skipDigits() {
+    const char *start = p_;
+    while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+      ++p_;
+    }
+    return p_ != start;
+  }
+
+  const char *begin_;
+  const char *p_;
+  const char *end_;
+  bool internStrings_;
+  std::vector<ValueVariant> values_;
+  std::vector<std::string> keys_;
+  std::string scratch_;
+
+  static constexpr size_t kAtomCacheSize = 256;
+  static constexpr size_t kShapeCacheSize = 64;
+  std::vector<Atom> atoms_;
+  Atom atomCache_[kAtomCacheSize];
+  std::shared_ptr<const Shape> shapeCache_[kShapeCacheSize];
+};
+
+// 迭代式 JSON 序列化器。容器以显式栈展开；对象进入时把可枚举属性一次性
+// 收集到共享的 entries_ 栈上，帧只记录其中的区间，不为每个对象分配。
+class JSONWriter {
+public:
+  explicit JSONWriter(JSONSink &sink) : sink_(sink) {}
+
+  void write(const ValueVariant &root) {
+    if (!writeValue(root)) {
+      sink_.write("null", 4);
+    }
+    while (!frames_.empty()) {
+      Frame &frame = frames_.back();
+      if (frame.array) {
+        if (frame.next == frame.end) {
+          sink_.put(']');
+          frames_.pop_back();
+          continue;
+        }
+        if (frame.next++ != 0) {
+          sink_.put(',');
+        }
+        if (!writeValue(frame.array->At(frame.next - 1))) {
+          sink_.write("null", 4);
+        }
+        continue;
+      }
+
+      if (frame.next == frame.end) {
+        entries_.resize(frame.begin);
+        sink_.put('}');
+        frames_.pop_back();
+        continue;
+      }
+      const size_t index = frame.next++;
+      const ValueVariant value = std::move(entries_[index].second);
+      if (isOmitted(value)) {
+        continue;
+      }
+      if (!frame.first) {
+        sink_.put(',');
+      }
+      frame.first = false;
+      writeString(*entries_[index].first);
+      sink_.put(':');
+      writeValue(value);
+    }
+    sink_.flush();
+  }
+
+private:
+  struct Frame {
+    Ref<JObject> holder;         // 保证遍历期间容器存活
+    const JArray *array = nullptr; // 非空时为数组帧
+    size_t begin = 0;            // 对象帧：entries_ 区间起点
+    size_t next = 0;
+    size_t end = 0;
+    bool first = true;
+  };
+
+  static bool isOmitted(const ValueVariant &value) {
+    return std::holds_alternative<JUndefined>(value) ||
+           std::holds_alternative<Ref<JFunction>>(value);
+  }
+
+  // 写出标量，或写出容器的起始括号并压栈；值应被省略时返回 false
+  bool writeValue(const ValueVariant &value) {
+    switch (static_cast<ValueType>(value.index())) {
+    case ValueType::Undefined:
+    case ValueType::Function:
+      return false;
+    case ValueType::Null:
+      sink_.write("null", 4);
+      return true;
+    case ValueType::Boolean:
+      if (std::get<bool>(value)) {
+        sink_.write("true", 4);
+      } else {
+        sink_.write("false", 5);
+      }
+      return true;
+    case ValueType::Int32:
+      writeInteger(std::get<int32_t>(value));
+      return true;
+    case ValueType::UInt32:
+      writeInteger(std::get<uint32_t>(value));
+      return true;
+    case ValueType::UInt64:
+      writeInteger(std::get<uint64_t>(value));
+      return true;
+    case ValueType::Double:
+      writeDouble(std::get<double>(value));
+      return true;
+    case ValueType::String: {
+      const auto &str = std::get<Ref<JString>>(value);
+      if (!str) {
+        sink_.write("null", 4);
+      } else {
+        writeString(str->view());
+      }
+      return true;
+    }
+    case ValueType::Date: {
+      const auto &date = std::get<Ref<JDate>>(value);
+      if (!date) {
+        sink_.write("null", 4);
+      } else {
+        writeString(date->toString());
+      }
+      return true;
+    }
+    case ValueType::Array: {
+      const auto &array = std::get<Ref<JArray>>(value);
+      if (!array) {
+        sink_.write("null", 4);
+        return true;
+      }
+      enter(array);
+      sink_.put('[');
+      Frame frame;
+      frame.holder = array;
+      frame.array = array.get();
+      frame.end = array->Size();
+      frames_.push_back(std::move(frame));
+      return true;
+    }
+    case ValueType::Object: {
+      const auto &object = std::get<Ref<JObject>>(value);
+      if (!object) {
+        sink_.write("null", 4);
+        return true;
+      }
+      enter(object);
+      sink_.put('{');
+      Frame frame;
+      frame.holder = object;
+      frame.begin = frame.next = entries_.size();
+      object->forEachProperty(
+          [this](const std::string &name, const ValueVariant &property) {
+            entries_.emplace_back(&name, property);
+          });
+      frame.end = entries_.size();
+      frames_.push_back(std::move(frame));
+      return true;
+    }
+    }
+    return false;
+  }
+
+  void enter(const Ref<JObject> &container) {
+    for (const auto &frame : frames_) {
+      if (frame.holder == container) {
+        throw std::invalid_argument(
+            "converting circular structure to JSON");
+      }
+    }
+  }
+
+  template <typename T> void writeInteger(T value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    sink_.write(buffer, static_cast<size_t>(result.ptr - buffer));
+  }
+
+  void writeDouble(double value) {
+    if (!std::isfinite(value)) {
+      sink_.write("null", 4);
+      return;
+    }
+    if (value == 0) {
+      // 与 JS 一致，-0 输出为 0
+      sink_.put('0');
+      return;
+    }
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    sink_.write(buffer, static_cast<size_t>(result.ptr - buffer));
+  }
+
+  void writeString(std::string_view str) {
+    static const char kHex[] = "0123456789abcdef";
+    sink_.put('"');
+    const char *p = str.data();
+    const char *end = p + str.size();
+    while (p < end) {
+      const char *special = scanStringSpecial(p, end);
+      sink_.write(p, static_cast<size_t>(special - p));
+      if (special == end) {
+        break;
+      }
+      const char ch = *special;
+      switch (ch) {
+      case '"':
+        sink_.write("\\\"", 2);
+        break;
+      case '\\':
+        sink_.write("\\\\", 2);
+        break;
+      case '\b':
+        sink_.write("\\b", 2);
+        break;
+      case '\f':
+        sink_.write("\\f", 2);
+        break;
+      case '\n':
+        sink_.write("\\n", 2);
+        break;
+      case '\r':
+        sink_.write("\\r", 2);
+        break;
+      case '\t':
+        sink_.write("\\t", 2);
+        break;
+      default: {
+        const char escaped[] = {'\\', 'u', '0', '0', kHex[(ch >> 4) & 0xF],
+                                kHex[ch & 0xF]};
+        sink_.write(escaped, sizeof(escaped));
+        break;
+      }
+      }
+      p = special + 1;
+    }
+    sink_.put('"');
+  }
+
+  JSONSink &sink_;
+  std::vector<Frame> frames_;
+  std::vector<std::pair<const std::string *, ValueVariant>> entries_;
+};
+
+// =======================
+// 输出目标实现
+// =======================
+
+JSONBufferSink::JSONBufferSink(size_t initialCapacity)
+    : buffer_(new char[std::max<size_t>(initialCapacity, 16)]) {
+  cur_ = buffer_.get();
+  end_ = cur_ + std::max<size_t>(initialCapacity, 16);
+}
+
+void JSONBufferSink::overflow(const char *data, size_t size) {
+  const size_t used = this->size();
+  const size_t capacity = static_cast<size_t>(end_ - buffer_.get());
+  const size_t grown = std::max(capacity * 2, used + size);
+  std::unique_ptr<char[]> buffer(new char[grown]);
+  std::memcpy(buffer.get(), buffer_.get(), used);
+  std::memcpy(buffer.get() + used, data, size);
+  buffer_ = std::move(buffer);
+  cur_ = buffer_.get() + used + size;
+  end_ = buffer_.get() + grown;
+}
+
+JSONFdSink::JSONFdSink(int fd, size_t chunkSize)
+    : fd_(fd), chunkSize_(std::max<size_t>(chunkSize, 16)),
+      buffer_(new char[chunkSize_]) {
+  cur_ = buffer_.get();
+  end_ = cur_ + chunkSize_;
+}
+
+JSONFdSink::~JSONFdSink() {
+  try {
+    flush();
+  } catch (const std::system_error &) {
+  }
+}
+
+void JSONFdSink::flush() {
+  const size_t pending = static_cast<size_t>(cur_ - buffer_.get());
+  cur_ = buffer_.get();
+  writeAll(buffer_.get(), pending);
+}
+
+void JSONFdSink::overflow(const char *data, size_t size) {
+  // 先补满当前块再整块写出，剩余部分不足一块时留在缓冲中
+  const size_t room = static_cast<size_t>(end_ - cur_);
+  std::memcpy(cur_, data, room);
+  cur_ = end_;
+  flush();
+  data += room;
+  size -= room;
+  if (size >= chunkSize_) {
+    writeAll(data, size);
+    return;
+  }
+  std::memcpy(cur_, data, size);
+  cur_ += size;
+}
+
+void JSONFdSink::writeAll(const char *data, size_t size) {
+  while (size > 0) {
+#ifdef _WIN32
+    const int written =
+        ::_write(fd_, data, static_cast<unsigned>(std::min<size_t>(
+                                size, std::numeric_limits<int>::max())));
+#else
+    const ssize_t written = ::write(fd_, data, size);
+#endif
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "JSON sink write failed");
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+void stringify(const ValueVariant &value, JSONSink &sink) {
+  JSONWriter(sink).write(value);
+}
+
+std::string stringify(const ValueVariant &value) {
+  JSONBufferSink sink;
+  stringify(value, sink);
+  return sink.str();
+}
+
+ValueVariant parseJSON(std::string_view json) {
+  return JSONParser(json).parseDocument();
+}
+
+ValueVariant parseJSON(std::string_view json, const JSONParseOptions &options) {
+  return JSONParser(json, options).parseDocument();
+}
+
+} // namespace utils
+
+} // namespace jobject
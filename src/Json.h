@@ -0,0 +1,152 @@
+#pragma once
+
+#include "JObject.h"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace jobject {
+
+// JSON 解析错误，offset 为出错位置在输入中的字节偏移
+class JSONParseError : public std::runtime_error {
+public:
+  JSONParseError(const std::string &message, size_t offset)
+      : std::runtime_error(message + " at offset " + std::to_string(offset)),
+        offset_(offset) {}
+
+  size_t offset() const { return offset_; }
+
+private:
+  size_t offset_;
+};
+
+namespace utils {
+
+// JSON 输出目标。序列化直接写入 [cur_, end_) 窗口，空间不足时才调用
+// overflow 交给具体目标处理，小块写入不经过虚函数调用。
+class JSONSink {
+public:
+  virtual ~JSONSink() = default;
+
+  void write(const char *data, size_t size) {
+    if (static_cast<size_t>(end_ - cur_) >= size) {
+      std::memcpy(cur_, data, size);
+      cur_ += size;
+    } else {
+      overflow(data, size);
+    }
+  }
+  void write(std::string_view text) { write(text.data(), text.size()); }
+  void put(char ch) {
+    if (cur_ != end_) {
+      *cur_++ = ch;
+    } else {
+      overflow(&ch, 1);
+    }
+  }
+
+  // 把已写入的内容交给目标；stringify 结束时调用
+  virtual void flush() {}
+
+protected:
+  // 窗口不足以容纳 size 字节时调用，实现必须消费全部数据
+  virtual void overflow(const char *data, size_t size) = 0;
+
+  char *cur_ = nullptr;
+  char *end_ = nullptr;
+};
+
+// 写入可复用的增长缓冲区；clear 后保留容量，供下一次序列化复用
+class JSONBufferSink : public JSONSink {
+public:
+  explicit JSONBufferSink(size_t initialCapacity = 4096);
+
+  std::string_view view() const {
+    return std::string_view(buffer_.get(), cur_ - buffer_.get());
+  }
+  std::string str() const { return std::string(view()); }
+  size_t size() const { return static_cast<size_t>(cur_ - buffer_.get()); }
+  void clear() { cur_ = buffer_.get(); }
+
+protected:
+  void overflow(const char *data, size_t size) override;
+
+private:
+  std::unique_ptr<char[]> buffer_;
+};
+
+// 写入文件描述符：内容先积累在 chunkSize 大小的缓冲中，满块时整块写出，
+// 大于一块的数据直接写出。写入失败时抛出 std::system_error。
+// 析构时写出剩余内容（忽略错误），需要得知错误时请显式调用 flush。
+class JSONFdSink : public JSONSink {
+public:
+  explicit JSONFdSink(int fd, size_t chunkSize = 64 * 1024);
+  ~JSONFdSink() override;
+
+  JSONFdSink(const JSONFdSink &) = delete;
+  JSONFdSink &operator=(const JSONFdSink &) = delete;
+
+  void flush() override;
+
+protected:
+  void overflow(const char *data, size_t size) override;
+
+private:
+  void writeAll(const char *data, size_t size);
+
+  int fd_;
+  size_t chunkSize_;
+  std::unique_ptr<char[]> buffer_;
+};
+
+/**
+ * @brief Serialize a value tree as JSON into a sink.
+ *
+ * The tree is walked with an explicit stack, so deep nesting does not
+ * recurse and no intermediate string is built per nested value. Objects
+ * emit their own enumerable named properties in insertion order; arrays
+ * emit their elements only. Following
+ * JSON.stringify, undefined and functions are omitted from objects and
+ * written as null in arrays and at the top level, non-finite numbers are
+ * written as null, and dates are written as their toString() text.
+ * Doubles use the shortest representation that round-trips.
+ *
+ * @param[in] value The root value.
+ * @param[in,out] sink Receives the output; flush() is called at the end.
+ * @throws std::invalid_argument if the tree contains a cycle.
+ */
+void stringify(const ValueVariant &value, JSONSink &sink);
+
+// 序列化为字符串
+std::string stringify(const ValueVariant &value);
+
+// 解析选项
+struct JSONParseOptions {
+  // 字符串值（不含对象键）经 internString 驻留，重复的值共享同一个 JString
+  bool internStrings = false;
+};
+
+/**
+ * @brief Parse a JSON document directly into a JObject/JArray/JString tree.
+ *
+ * Integers are stored as int32_t when they fit, otherwise as uint32_t or
+ * uint64_t for non-negative values, and as double in every other case
+ * (fractions, exponents, "-0" and out-of-range negatives). String contents
+ * are copied verbatim apart from escape sequences; the input is not
+ * validated as UTF-8. Duplicate keys keep the last value.
+ *
+ * @param[in] json The complete JSON text.
+ * @return The root value.
+ * @throws JSONParseError if the text is not a single valid JSON value or
+ *         nests deeper than 1024 levels.
+ */
+ValueVariant parseJSON(std::string_view json);
+ValueVariant parseJSON(std::string_view json, const JSONParseOptions &options);
+
+} // namespace utils
+
+} // namespace jobject
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "CompactValue.h"
+#include "Value.h"
+
+namespace jobject {
+
+// 属性描述符
+struct PropertyDescriptor {
+  ValueVariant value;
+  bool writable = true;
+  bool enumerable = true;
+  bool configurable = true;
+  std::function<ValueVariant()> getter = nullptr;
+  std::function<void(const ValueVariant &)> setter = nullptr;
+};
+
+// 访问器属性的 getter/setter，只有访问器属性才单独分配
+struct PropertyAccessor {
+  std::function<ValueVariant()> getter;
+  std::function<void(const ValueVariant &)> setter;
+};
+
+// 属性在对象内部的存储形式。数据属性只占一个 CompactValue 和一个属性位字节，
+// getter/setter 另行分配在 accessor 中，数据属性的 accessor 为空。
+// 与 PropertyDescriptor 的转换发生在 defineProperty 等 API 边界上
+struct PropertySlot {
+  enum Attribute : uint8_t {
+    kWritable = 1 << 0,
+    kEnumerable = 1 << 1,
+    kConfigurable = 1 << 2,
+    kDefaultAttributes = kWritable | kEnumerable | kConfigurable,
+  };
+
+  PropertySlot() = default;
+  explicit PropertySlot(const ValueVariant &value,
+                        uint8_t attributes = kDefaultAttributes)
+      : value(value), attributes(attributes) {}
+  explicit PropertySlot(const PropertyDescriptor &descriptor)
+      : value(descriptor.value),
+        attributes(static_cast<uint8_t>(
+            (descriptor.writable ? kWritable : 0) |
+            (descriptor.enumerable ? kEnumerable : 0) |
+            (descriptor.configurable ? kConfigurable : 0))) {
+    if (descriptor.getter || descriptor.setter) {
+      accessor.reset(
+          new PropertyAccessor{descriptor.getter, descriptor.setter});
+    }
+  }
+
+  bool writable() const { return attributes & kWritable; }
+  bool enumerable() const { return attributes & kEnumerable; }
+  bool configurable() const { return attributes & kConfigurable; }
+  bool isAccessor() const { return accessor != nullptr; }
+
+  CompactValue value;
+  std::unique_ptr<PropertyAccessor> accessor;
+  uint8_t attributes = kDefaultAttributes;
+};
+
+static_assert(sizeof(PropertySlot) <= 3 * sizeof(void *),
+              "PropertySlot must stay compact");
+
+// 快速模式对象的槽位数组：前 kInlineCapacity 个槽位直接存放在对象内部，
+// 属性不多的对象不需要额外的堆分配，读取槽位也不必再跳转一次指针。
+// 超出后整体搬到堆上，按两倍增长。
+class SlotStorage {
+public:
+  static constexpr size_t kInlineCapacity = 4;
+
+  SlotStorage() = default;
+  SlotStorage(const SlotStorage &) = delete;
+  SlotStorage &operator=(const SlotStorage &) = delete;
+  ~SlotStorage() { clear(); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  PropertySlot &operator[](size_t index) { return data_[index]; }
+  const PropertySlot &operator[](size_t index) const { return data_[index]; }
+  PropertySlot &back() { return data_[size_ - 1]; }
+
+  template <typename... Args> PropertySlot &emplace_back(Args &&...args) {
+    if (size_ == capacity_) {
+      grow(capacity_ * 2);
+    }
+    new (data_ + size_) PropertySlot(std::forward<Args>(args)...);
+    return data_[size_++];
+  }
+
+  void pop_back() { data_[--size_].~PropertySlot(); }
+
+  void reserve(size_t capacity) {
+    if (capacity > capacity_) {
+      grow(capacity);
+    }
+  }
+
+  // 销毁全部槽位并释放堆存储，回到内联存储
+  void clear() {
+    for (size_t i = 0; i < size_; ++i) {
+      data_[i].~PropertySlot();
+    }
+    size_ = 0;
+    if (data_ != inlineData()) {
+      ::operator delete(data_);
+      data_ = inlineData();
+      capacity_ = kInlineCapacity;
+    }
+  }
+
+private:
+  PropertySlot *inlineData() {
+    return reinterpret_cast<PropertySlot *>(inline_);
+  }
+
+  void grow(size_t capacity) {
+    auto *data = static_cast<PropertySlot *>(
+        ::operator new(capacity * sizeof(PropertySlot)));
+    for (size_t i = 0; i < size_; ++i) {
+      new (data + i) PropertySlot(std::move(data_[i]));
+      data_[i].~PropertySlot();
+    }
+    if (data_ != inlineData()) {
+      ::operator delete(data_);
+    }
+    data_ = data;
+    capacity_ = static_cast<uint32_t>(capacity);
+  }
+
+  PropertySlot *data_ = inlineData();
+  uint32_t size_ = 0;
+  uint32_t capacity_ = kInlineCapacity;
+  alignas(PropertySlot) unsigned char
+      inline_[kInlineCapacity * sizeof(PropertySlot)];
+};
+
+} // namespace jobject
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#ifndef JOBJECT_SINGLE_THREADED
+#include <atomic>
+#endif
+
+namespace jobject {
+
+// 侵入式引用计数基类：计数保存在对象内部，无需独立的控制块。
+//
+// 计数策略在编译期选择：默认使用原子计数，可跨线程共享对象；
+// 定义 JOBJECT_SINGLE_THREADED 后使用普通整数计数，拷贝句柄不再产生原子操作，
+// 此时同一对象图只能在单个线程内使用。该宏必须对库与使用方一致定义
+// （CMake 选项 JOBJECT_SINGLE_THREADED 会以 PUBLIC 方式传递）。
+class RefCounted {
+public:
+  void retainRef() const noexcept {
+#ifdef JOBJECT_SINGLE_THREADED
+    ++refCount_;
+#else
+    refCount_.fetch_add(1, std::memory_order_relaxed);
+#endif
+  }
+
+  // 返回 true 表示计数归零，调用方负责释放对象
+  bool releaseRef() const noexcept {
+#ifdef JOBJECT_SINGLE_THREADED
+    return --refCount_ == 0;
+#else
+    return refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+#endif
+  }
+
+  // 计数不为零时增加计数并返回 true；为零说明对象正在释放，返回 false。
+  // 供不持有引用的弱表由裸指针取得强引用
+  bool tryRetainRef() const noexcept {
+#ifdef JOBJECT_SINGLE_THREADED
+    if (refCount_ == 0) {
+      return false;
+    }
+    ++refCount_;
+    return true;
+#else
+    uint32_t count = refCount_.load(std::memory_order_relaxed);
+    while (count != 0) {
+      if (refCount_.compare_exchange_weak(count, count + 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+#endif
+  }
+
+  uint32_t refCount() const noexcept {
+#ifdef JOBJECT_SINGLE_THREADED
+    return refCount_;
+#else
+    return refCount_.load(std::memory_order_relaxed);
+#endif
+  }
+
+protected:
+  RefCounted() noexcept = default;
+  // 拷贝对象不拷贝引用计数，新对象从零开始
+  RefCounted(const RefCounted &) noexcept {}
+  RefCounted &operator=(const RefCounted &) noexcept { return *this; }
+  ~RefCounted() = default;
+
+private:
+#ifdef JOBJECT_SINGLE_THREADED
+  mutable uint32_t refCount_ = 0;
+#else
+  mutable std::atomic<uint32_t> refCount_{0};
+#endif
+};
+
+// 指向 RefCounted 派生对象的强引用句柄，接口与 std::shared_ptr 保持一致
+// （get、->、*、bool、reset、use_count 以及比较运算）。
+// 句柄只占一个指针；计数归零时通过虚析构函数释放对象。
+// 从裸指针构造会增加计数，因此可以由 this 重新得到句柄；
+// 但对象必须由 new 分配（通常经 makeRef 创建），不能指向栈上或成员对象。
+template <typename T> class Ref {
+public:
+  using element_type = T;
+
+  constexpr Ref() noexcept = default;
+  constexpr Ref(std::nullptr_t) noexcept {}
+  explicit Ref(T *ptr) noexcept : ptr_(ptr) { retain(); }
+
+  Ref(const Ref &other) noexcept : ptr_(other.ptr_) { retain(); }
+  Ref(Ref &&other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; }
+
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+  Ref(const Ref<U> &other) noexcept : ptr_(other.get()) {
+    retain();
+  }
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+  Ref(Ref<U> &&other) noexcept : ptr_(other.detach()) {}
+
+  ~Ref() { release(); }
+
+  Ref &operator=(const Ref &other) noexcept {
+    Ref(other).swap(*this);
+    return *this;
+  }
+  Ref &operator=(Ref &&other) noexcept {
+    Ref(std::move(other)).swap(*this);
+    return *this;
+  }
+  Ref &operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  T *get() const noexcept { return ptr_; }
+  T *operator->() const noexcept { return ptr_; }
+  T &operator*() const noexcept { return *ptr_; }
+  explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+  void reset() noexcept { Ref().swap(*this); }
+  void reset(T *ptr) noexcept { Ref(ptr).swap(*this); }
+  void swap(Ref &other) noexcept { std::swap(ptr_, other.ptr_); }
+
+  long use_count() const noexcept {
+    return ptr_ ? static_cast<long>(ptr_->refCount()) : 0;
+  }
+
+  // 放弃所有权并返回裸指针，计数保持不变（供句柄间转移使用）
+  T *detach() noexcept {
+    T *ptr = ptr_;
+    ptr_ = nullptr;
+    return ptr;
+  }
+
+  // 接管一个已计入引用的裸指针，不再增加计数
+  static Ref adopt(T *ptr) noexcept {
+    Ref ref;
+    ref.ptr_ = ptr;
+    return ref;
+  }
+
+private:
+  void retain() const noexcept {
+    if (ptr_) {
+      ptr_->retainRef();
+    }
+  }
+  void release() noexcept {
+    if (ptr_ && ptr_->releaseRef()) {
+      delete ptr_;
+    }
+  }
+
+  T *ptr_ = nullptr;
+};
+
+template <typename T, typename... Args> Ref<T> makeRef(Args &&...args) {
+  return Ref<T>(new T(std::forward<Args>(args)...));
+}
+
+template <typename T, typename U>
+Ref<T> static_pointer_cast(const Ref<U> &ref) noexcept {
+  return Ref<T>(static_cast<T *>(ref.get()));
+}
+
+template <typename T, typename U>
+Ref<T> dynamic_pointer_cast(const Ref<U> &ref) noexcept {
+  return Ref<T>(dynamic_cast<T *>(ref.get()));
+}
+
+template <typename T, typename U>
+bool operator==(const Ref<T> &a, const Ref<U> &b) noexcept {
+  return a.get() == b.get();
+}
+template <typename T, typename U>
+bool operator!=(const Ref<T> &a, const Ref<U> &b) noexcept {
+  return a.get() != b.get();
+}
+template <typename T, typename U>
+bool operator<(const Ref<T> &a, const Ref<U> &b) noexcept {
+  return std::less<const void *>()(a.get(), b.get());
+}
+template <typename T>
+bool operator==(const Ref<T> &a, std::nullptr_t) noexcept {
+  return !a;
+}
+template <typename T>
+bool operator==(std::nullptr_t, const Ref<T> &a) noexcept {
+  return !a;
+}
+template <typename T>
+bool operator!=(const Ref<T> &a, std::nullptr_t) noexcept {
+  return static_cast<bool>(a);
+}
+template <typename T>
+bool operator!=(std::nullptr_t, const Ref<T> &a) noexcept {
+  return static_cast<bool>(a);
+}
+
+} // namespace jobject
+
+namespace std {
+template <typename T> struct hash<jobject::Ref<T>> {
+  size_t operator()(const jobject::Ref<T> &ref) const noexcept {
+    return std::hash<T *>()(ref.get());
+  }
+};
+} // namespace std
@@ -0,0 +1,115 @@
+#include "Shape.h"
+
+#include <mutex>
+
+namespace jobject {
+
+namespace {
+
+// 转移树全局共享，新增/回收转移边时需要加锁；属性读取只访问不可变部分，无需加锁。
+std::mutex &transitionMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+} // namespace
+
+Shape::Shape(std::shared_ptr<const Shape> parent, Atom key)
+    : parent_(std::move(parent)), key_(key) {
+  keys_.reserve(parent_->keys_.size() + 1);
+  keys_.insert(keys_.end(), parent_->keys_.begin(), parent_->keys_.end());
+  keys_.push_back(Key{key_, key_.hash()});
+  if (keys_.size() <= kLinearLookupMax) {
+    return;
+  }
+
+  // 容量取不小于两倍键数的 2 的幂，保证探测链较短
+  size_t capacity = 4;
+  while (capacity < keys_.size() * 2) {
+    capacity <<= 1;
+  }
+  index_.assign(capacity, kNotFound);
+  const size_t mask = capacity - 1;
+  for (size_t slot = 0; slot < keys_.size(); ++slot) {
+    size_t pos = keys_[slot].hash & mask;
+    while (index_[pos] != kNotFound) {
+      pos = (pos + 1) & mask;
+    }
+    index_[pos] = static_cast<uint32_t>(slot);
+  }
+}
+
+Shape::~Shape() {
+  if (!parent_) {
+    return;
+  }
+  // 从父节点摘除已失效的转移边；若同名转移已被其他线程重新创建则保留。
+  std::lock_guard<std::mutex> lock(transitionMutex());
+  auto it = parent_->transitions_.find(key_);
+  if (it != parent_->transitions_.end() && it->second.expired()) {
+    parent_->transitions_.erase(it);
+  }
+}
+
+const std::shared_ptr<const Shape> &Shape::root() {
+  // 有意泄漏，避免静态析构顺序导致仍存活的对象引用已析构的根节点
+  static const auto *rootShape =
+      new std::shared_ptr<const Shape>(std::shared_ptr<Shape>(new Shape()));
+  return *rootShape;
+}
+
+std::shared_ptr<const Shape> Shape::addProperty(Atom key) const {
+  std::lock_guard<std::mutex> lock(transitionMutex());
+  auto &transition = transitions_[key];
+  if (auto child = transition.lock()) {
+    return child;
+  }
+  std::shared_ptr<const Shape> child(new Shape(shared_from_this(), key));
+  transition = child;
+  return child;
+}
+
+uint32_t Shape::lookup(Atom key) const {
+  if (index_.empty()) {
+    for (size_t slot = 0; slot < keys_.size(); ++slot) {
+      if (keys_[slot].atom == key) {
+        return static_cast<uint32_t>(slot);
+      }
+    }
+    return kNotFound;
+  }
+  const size_t mask = index_.size() - 1;
+  for (size_t pos = key.hash() & mask;; pos = (pos + 1) & mask) {
+    const uint32_t slot = index_[pos];
+    if (slot == kNotFound || keys_[slot].atom == key) {
+      return slot;
+    }
+  }
+}
+
+uint32_t Shape::lookup(std::string_view key) const {
+  if (keys_.empty()) {
+    return kNotFound;
+  }
+  const size_t hash = hashPropertyName(key);
+  if (index_.empty()) {
+    for (size_t slot = 0; slot < keys_.size(); ++slot) {
+      if (keys_[slot].hash == hash && keys_[slot].atom.str() == key) {
+        return static_cast<uint32_t>(slot);
+      }
+    }
+    return kNotFound;
+  }
+  const size_t mask = index_.size() - 1;
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    const uint32_t slot = index_[pos];
+    if (slot == kNotFound) {
+      return kNotFound;
+    }
+    if (keys_[slot].hash == hash && keys_[slot].atom.str() == key) {
+      return slot;
+    }
+  }
+}
+
+} // namespace jobject
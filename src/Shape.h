@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Atom.h"
+
+namespace jobject {
+
+// 隐藏类（shape）：描述对象按插入顺序排列的属性键以及每个键对应的槽位下标。
+// 以相同键序列构建的对象共享同一个 Shape，对象自身只保存紧凑的槽位数组。
+// Shape 构成一棵转移树：从根 Shape 出发，每追加一个属性键就沿转移边
+// 走到（或创建）子 Shape。Shape 创建后不可变，可在线程间共享读取。
+class Shape : public std::enable_shared_from_this<Shape> {
+public:
+  // 查找失败时返回的槽位下标
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+
+  // 快速模式下单个对象允许的最大属性数，超过后对象转为字典模式，
+  // 避免转移树无限加深。
+  static constexpr size_t kMaxProperties = 64;
+
+  // 属性数不超过该值的 Shape 不建索引，查找时线性扫描键数组：
+  // 按原子只比较整数，按字符串先比较哈希，小对象的查找只触及一两条缓存行
+  static constexpr size_t kLinearLookupMax = 8;
+
+  ~Shape();
+
+  Shape(const Shape &) = delete;
+  Shape &operator=(const Shape &) = delete;
+
+  // 空对象共享的根 Shape
+  static const std::shared_ptr<const Shape> &root();
+
+  // 返回追加属性 key 后的子 Shape，已有转移时直接复用
+  std::shared_ptr<const Shape> addProperty(Atom key) const;
+
+  // 返回 key 对应的槽位下标，不存在时返回 kNotFound。
+  // 按原子查找使用预计算哈希；按字符串查找无需驻留，不访问原子表的锁。
+  uint32_t lookup(Atom key) const;
+  uint32_t lookup(std::string_view key) const;
+
+  // 按插入顺序访问属性键
+  size_t propertyCount() const { return keys_.size(); }
+  Atom keyAt(size_t slot) const { return keys_[slot].atom; }
+
+  // 去掉最后一个属性后的 Shape（根 Shape 返回空指针）
+  const std::shared_ptr<const Shape> &parent() const { return parent_; }
+
+private:
+  Shape() = default;
+  Shape(std::shared_ptr<const Shape> parent, Atom key);
+
+  std::shared_ptr<const Shape> parent_;
+  Atom key_;
+
+  // 键与其哈希相邻保存，查找时无需访问原子表
+  struct Key {
+    Atom atom;
+    size_t hash;
+  };
+
+  std::vector<Key> keys_;
+  // 开放寻址索引：按键哈希定位，存放槽位下标，空位为 kNotFound。
+  // 小 Shape（不超过 kLinearLookupMax 个键）不建索引
+  std::vector<uint32_t> index_;
+
+  // 子 Shape 以弱引用保存，无对象使用的 Shape 会被自动释放
+  mutable std::unordered_map<Atom, std::weak_ptr<const Shape>> transitions_;
+};
+
+} // namespace jobject
@@ -0,0 +1,303 @@
+#include "StringSearch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JOBJECT_SEARCH_SSE2 1
+#endif
+
+// AVX2 内核以函数级 target 属性单独编译，运行时按 CPU 能力选用，
+// 整个库仍可按 SSE2 基线编译
+#if defined(JOBJECT_SEARCH_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define JOBJECT_SEARCH_AVX2 1
+#endif
+
+namespace jobject {
+
+namespace utils {
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+// 内核的前提：1 <= needle.size() <= haystack.size()，
+// 正向查找时 from <= haystack.size() - needle.size()，反向查找时 from
+// 不超过同一上界。first、second 为过滤字节在查找串中的偏移。
+using SearchKernel = size_t (*)(std::string_view haystack,
+                                std::string_view needle, size_t first,
+                                size_t second, size_t from);
+
+#ifndef JOBJECT_SEARCH_SSE2
+size_t findScalar(std::string_view haystack, std::string_view needle, size_t,
+                  size_t, size_t from) {
+  return haystack.find(needle, from);
+}
+
+size_t rfindScalar(std::string_view haystack, std::string_view needle, size_t,
+                   size_t, size_t from) {
+  return haystack.rfind(needle, from);
+}
+#endif
+
+#ifdef JOBJECT_SEARCH_SSE2
+inline unsigned lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned highestBit(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+}
+
+// 以 block 起始的 16 个位置中，两个过滤字节都吻合的位置掩码
+inline uint32_t sse2Candidates(const char *block, __m128i firstByte,
+                               __m128i secondByte, size_t first,
+                               size_t second) {
+  const __m128i a =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + first));
+  const __m128i b =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + second));
+  return static_cast<uint32_t>(_mm_movemask_epi8(
+      _mm_and_si128(_mm_cmpeq_epi8(a, firstByte),
+                    _mm_cmpeq_epi8(b, secondByte))));
+}
+
+size_t findSse2(std::string_view haystack, std::string_view needle,
+                size_t first, size_t second, size_t from) {
+  const char *data = haystack.data();
+  const size_t k = needle.size();
+  const __m128i firstByte = _mm_set1_epi8(needle[first]);
+  const __m128i secondByte = _mm_set1_epi8(needle[second]);
+  size_t i = from;
+  // 块内 16 个起始位置都必须能容纳整个查找串
+  for (; i + k + 15 <= haystack.size(); i += 16) {
+    uint32_t mask =
+        sse2Candidates(data + i, firstByte, secondByte, first, second);
+    while (mask) {
+      const size_t pos = i + lowestBit(mask);
+      if (std::memcmp(data + pos, needle.data(), k) == 0) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return haystack.find(needle, i);
+}
+
+size_t rfindSse2(std::string_view haystack, std::string_view needle,
+                 size_t first, size_t second, size_t from) {
+  const char *data = haystack.data();
+  const size_t k = needle.size();
+  const __m128i firstByte = _mm_set1_epi8(needle[first]);
+  const __m128i secondByte = _mm_set1_epi8(needle[second]);
+  // 每次检查起始位置 [from - 15, from]，从高位向低位确认候选
+  for (; from >= 15; from -= 16) {
+    const size_t base = from - 15;
+    uint32_t mask =
+        sse2Candidates(data + base, firstByte, secondByte, first, second);
+    while (mask) {
+      const unsigned bit = highestBit(mask);
+      if (std::memcmp(data + base + bit, needle.data(), k) == 0) {
+        return base + bit;
+      }
+      mask &= ~(1u << bit);
+    }
+    if (from == 15) {
+      return npos;
+    }
+  }
+  return haystack.rfind(needle, from);
+}
+#endif
+
+#ifdef JOBJECT_SEARCH_AVX2
+__attribute__((target("avx2"))) inline uint32_t
+avx2Candidates(const char *block, __m256i firstByte, __m256i secondByte,
+               size_t first, size_t second) {
+  const __m256i a =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + first));
+  const __m256i b =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + second));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(
+      _mm256_and_si256(_mm256_cmpeq_epi8(a, firstByte),
+                       _mm256_cmpeq_epi8(b, secondByte))));
+}
+
+__attribute__((target("avx2"))) size_t findAvx2(std::string_view haystack,
+                                                std::string_view needle,
+                                                size_t first, size_t second,
+                                                size_t from) {
+  const char *data = haystack.data();
+  const size_t k = needle.size();
+  const __m256i firstByte = _mm256_set1_epi8(needle[first]);
+  const __m256i secondByte = _mm256_set1_epi8(needle[second]);
+  size_t i = from;
+  for (; i + k + 31 <= haystack.size(); i += 32) {
+    uint32_t mask =
+        avx2Candidates(data + i, firstByte, secondByte, first, second);
+    while (mask) {
+      const size_t pos = i + lowestBit(mask);
+      if (std::memcmp(data + pos, needle.data(), k) == 0) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return findSse2(haystack, needle, first, second, i);
+}
+
+__attribute__((target("avx2"))) size_t rfindAvx2(std::string_view haystack,
+                                                 std::string_view needle,
+                                                 size_t first, size_t second,
+                                                 size_t from) {
+  const char *data = haystack.data();
+  const size_t k = needle.size();
+  const __m256i firstByte = _mm256_set1_epi8(needle[first]);
+  const __m256i secondByte = _mm256_set1_epi8(needle[second]);
+  for (; from >= 31; from -= 32) {
+    const size_t base = from - 31;
+    uint32_t mask =
+        avx2Candidates(data + base, firstByte, secondByte, first, second);
+    while (mask) {
+      const unsigned bit = highestBit(mask);
+      if (std::memcmp(data + base + bit, needle.data(), k) == 0) {
+        return base + bit;
+      }
+      mask &= ~(1u << bit);
+    }
+    if (from == 31) {
+      return npos;
+    }
+  }
+  return rfindSse2(haystack, needle, first, second, from);
+}
+#endif
+
+struct SearchKernels {
+  SearchKernel find;
+  SearchKernel rfind;
+};
+
+SearchKernels selectKernels() {
+#ifdef JOBJECT_SEARCH_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {&findAvx2, &rfindAvx2};
+  }
+#endif
+#ifdef JOBJECT_SEARCH_SSE2
+  return {&findSse2, &rfindSse2};
+#else
+  return {&findScalar, &rfindScalar};
+#endif
+}
+
+const SearchKernels &kernels() {
+  static const SearchKernels selected = selectKernels();
+  return selected;
+}
+
+// 字节在常见文本（英文、JSON、日志）中的大致常见程度，越小越少见
+unsigned byteFrequency(unsigned char ch) {
+  if (ch == ' ' || ch == 'e' || ch == 't' || ch == 'a' || ch == 'o' ||
+      ch == 'i' || ch == 'n' || ch == 's' || ch == 'r') {
+    return 4;
+  }
+  if ((ch >= 'a' && ch <= 'z') || ch == '"' || ch == ',' || ch == ':') {
+    return 3;
+  }
+  if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'Z') || ch == '.' ||
+      ch == '-' || ch == '_' || ch == '/' || ch == '\n') {
+    return 2;
+  }
+  return 1;
+}
+
+size_t searchForward(std::string_view haystack, std::string_view needle,
+                     size_t first, size_t second, size_t from) {
+  if (needle.empty()) {
+    return from <= haystack.size() ? from : npos;
+  }
+  if (needle.size() > haystack.size() ||
+      from > haystack.size() - needle.size()) {
+    return npos;
+  }
+  return kernels().find(haystack, needle, first, second, from);
+}
+
+size_t searchBackward(std::string_view haystack, std::string_view needle,
+                      size_t first, size_t second, size_t from) {
+  if (needle.size() > haystack.size()) {
+    return npos;
+  }
+  from = std::min(from, haystack.size() - needle.size());
+  if (needle.empty()) {
+    return from;
+  }
+  return kernels().rfind(haystack, needle, first, second, from);
+}
+
+} // namespace
+
+size_t indexOf(std::string_view haystack, std::string_view needle,
+               size_t from) {
+  return searchForward(haystack, needle, 0,
+                       needle.empty() ? 0 : needle.size() - 1, from);
+}
+
+size_t lastIndexOf(std::string_view haystack, std::string_view needle,
+                   size_t from) {
+  return searchBackward(haystack, needle, 0,
+                        needle.empty() ? 0 : needle.size() - 1, from);
+}
+
+StringSearcher::StringSearcher(std::string_view needle) : needle_(needle) {
+  if (needle_.size() < 2) {
+    return;
+  }
+  // 选出最少见的两个不同位置；频率相同时取靠后的，末尾字节通常区分度更高
+  size_t best = 0;
+  size_t next = 1;
+  if (byteFrequency(needle_[1]) <= byteFrequency(needle_[0])) {
+    std::swap(best, next);
+  }
+  for (size_t i = 2; i < needle_.size(); ++i) {
+    const unsigned rank = byteFrequency(needle_[i]);
+    if (rank <= byteFrequency(needle_[best])) {
+      next = best;
+      best = i;
+    } else if (rank <= byteFrequency(needle_[next])) {
+      next = i;
+    }
+  }
+  first_ = best;
+  second_ = next;
+}
+
+size_t StringSearcher::find(std::string_view haystack, size_t from) const {
+  return searchForward(haystack, needle_, first_, second_, from);
+}
+
+size_t StringSearcher::rfind(std::string_view haystack, size_t from) const {
+  return searchBackward(haystack, needle_, first_, second_, from);
+}
+
+} // namespace utils
+
+} // namespace jobject
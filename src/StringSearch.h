@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace jobject {
+
+namespace utils {
+
+/**
+ * @brief Find the first occurrence of needle in haystack at or after from.
+ *
+ * Candidate positions are filtered 16 or 32 bytes at a time by comparing
+ * two bytes of the needle (SSE2, or AVX2 when the CPU supports it; the
+ * kernel is chosen once at startup), and only candidates passing the
+ * filter are compared in full. Other targets use a scalar search.
+ *
+ * @return Byte offset of the match, or std::string_view::npos. An empty
+ *         needle matches at from when from <= haystack.size().
+ */
+size_t indexOf(std::string_view haystack, std::string_view needle,
+               size_t from = 0);
+
+/**
+ * @brief Find the last occurrence of needle in haystack starting at or
+ * before from, scanning backwards with the same kernels as indexOf.
+ *
+ * @return Byte offset of the match, or std::string_view::npos.
+ */
+size_t lastIndexOf(std::string_view haystack, std::string_view needle,
+                   size_t from = std::string_view::npos);
+
+// 预编译的查找串：复制并分析一次，之后在任意多个文本中查找。
+// 过滤用的两个字节按常见文本中的出现频率挑选较少见的，
+// 比固定使用首尾字节产生更少的候选位置。
+class StringSearcher {
+public:
+  explicit StringSearcher(std::string_view needle);
+
+  const std::string &needle() const { return needle_; }
+
+  size_t find(std::string_view haystack, size_t from = 0) const;
+  size_t rfind(std::string_view haystack,
+               size_t from = std::string_view::npos) const;
+
+private:
+  std::string needle_;
+  // 过滤字节在查找串中的偏移
+  size_t first_ = 0;
+  size_t second_ = 0;
+};
+
+} // namespace utils
+
+} // namespace jobject
@@ -0,0 +1,99 @@
+#include "StringTable.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "JObject.h"
+
+namespace jobject {
+
+namespace {
+
+constexpr size_t kShardCount = 16;
+
+// 键指向驻留字符串自身的字节，条目在字符串释放前移除，键始终有效
+struct StringShard {
+  mutable std::shared_mutex mutex;
+  std::unordered_map<std::string_view, JString *> strings;
+};
+
+StringShard *shards() {
+  // 有意泄漏，保证静态析构期间释放驻留字符串时表依然可用
+  static auto *table = new StringShard[kShardCount];
+  return table;
+}
+
+StringShard &shardFor(size_t hash) { return shards()[hash % kShardCount]; }
+
+// 命中且对象未在释放时返回强引用
+Ref<JString> retainEntry(const StringShard &shard, std::string_view text) {
+  auto it = shard.strings.find(text);
+  if (it != shard.strings.end() && it->second->tryRetainRef()) {
+    return Ref<JString>::adopt(it->second);
+  }
+  return nullptr;
+}
+
+} // namespace
+
+Ref<JString> StringTable::intern(std::string_view text) {
+  const size_t hash = JString::hashOf(text);
+  StringShard &shard = shardFor(hash);
+  {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    if (auto existing = retainEntry(shard, text)) {
+      return existing;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  if (auto existing = retainEntry(shard, text)) {
+    return existing;
+  }
+  auto str = makeRef<JString>(std::string(text));
+  str->interned_ = true;
+  // 分片已算出内容哈希，直接缓存
+  str->hash_.store(hash, std::memory_order_relaxed);
+  // 旧条目的字符串正在释放：键指向它的字节，必须连同键一起替换
+  shard.strings.erase(text);
+  shard.strings.emplace(str->view(), str.get());
+  return str;
+}
+
+Ref<JString> StringTable::find(std::string_view text) {
+  const StringShard &shard = shardFor(JString::hashOf(text));
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
+  return retainEntry(shard, text);
+}
+
+size_t StringTable::size() {
+  size_t count = 0;
+  for (size_t i = 0; i < kShardCount; ++i) {
+    std::shared_lock<std::shared_mutex> lock(shards()[i].mutex);
+    count += shards()[i].strings.size();
+  }
+  return count;
+}
+
+void StringTable::remove(const JString *str) {
+  const std::string_view text = str->view();
+  StringShard &shard = shardFor(str->Hash());
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  auto it = shard.strings.find(text);
+  // 条目可能已被新的驻留字符串替换
+  if (it != shard.strings.end() && it->second == str) {
+    shard.strings.erase(it);
+  }
+}
+
+namespace utils {
+
+Ref<JString> internString(std::string_view str) {
+  return StringTable::intern(str);
+}
+
+} // namespace utils
+
+} // namespace jobject
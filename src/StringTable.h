@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "Ref.h"
+
+namespace jobject {
+
+class JString;
+
+// 字符串驻留表：内容相同的驻留字符串共享同一个 JString。
+//
+// 表不持有引用（弱表）：条目只记录裸指针，驻留字符串在释放或被修改时
+// 把自己从表中移除。查找命中时以 tryRetainRef 取得强引用，
+// 计数已归零（正在释放）的条目视为不存在并由新字符串替换。
+// 表按哈希分为若干分片，每个分片由独立的读写锁保护，命中只需共享锁。
+class StringTable {
+public:
+  // 返回内容为 text 的驻留字符串，不存在时创建
+  static Ref<JString> intern(std::string_view text);
+  // 仅查找，不存在时返回空引用
+  static Ref<JString> find(std::string_view text);
+  // 当前驻留的字符串数量
+  static size_t size();
+
+  // 由 JString 在释放或修改内容前调用
+  static void remove(const JString *str);
+};
+
+} // namespace jobject
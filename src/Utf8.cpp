@@ -0,0 +1,186 @@
+#include "Utf8.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JOBJECT_UTF8_SSE2 1
+#endif
+
+namespace jobject {
+
+namespace utils {
+
+bool isAscii(std::string_view text) {
+  const char *p = text.data();
+  const char *end = p + text.size();
+#ifdef JOBJECT_UTF8_SSE2
+  // 先把各块按位或起来，最后只检查一次最高位
+  __m128i bits = _mm_setzero_si128();
+  for (; end - p >= 16; p += 16) {
+    bits = _mm_or_si128(
+        bits, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+  if (_mm_movemask_epi8(bits) != 0) {
+    return false;
+  }
+#endif
+  unsigned char tail = 0;
+  for (; p < end; ++p) {
+    tail |= static_cast<unsigned char>(*p);
+  }
+  return tail < 0x80;
+}
+
+uint32_t decodeUtf8(const char *&p, const char *end) {
+  const auto lead = static_cast<unsigned char>(*p);
+  if (lead < 0x80) {
+    ++p;
+    return lead;
+  }
+  size_t length;
+  uint32_t codePoint;
+  uint32_t minimum;
+  if ((lead & 0xE0) == 0xC0) {
+    length = 2;
+    codePoint = lead & 0x1F;
+    minimum = 0x80;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 3;
+    codePoint = lead & 0x0F;
+    minimum = 0x800;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 4;
+    codePoint = lead & 0x07;
+    minimum = 0x10000;
+  } else {
+    ++p;
+    return 0xFFFD;
+  }
+  if (static_cast<size_t>(end - p) < length) {
+    ++p;
+    return 0xFFFD;
+  }
+  for (size_t i = 1; i < length; ++i) {
+    const auto byte = static_cast<unsigned char>(p[i]);
+    if ((byte & 0xC0) != 0x80) {
+      ++p;
+      return 0xFFFD;
+    }
+    codePoint = (codePoint << 6) | (byte & 0x3F);
+  }
+  // 过长编码、代理区与超出范围的码点都视为非法
+  if (codePoint < minimum || codePoint > 0x10FFFF ||
+      (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+    ++p;
+    return 0xFFFD;
+  }
+  p += length;
+  return codePoint;
+}
+
+void appendUtf8(std::string &out, uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    out.push_back(static_cast<char>(codePoint));
+  } else if (codePoint < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else if (codePoint < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+}
+
+} // namespace utils
+
+namespace {
+
+inline size_t utf16Width(uint32_t codePoint) {
+  return codePoint >= 0x10000 ? 2 : 1;
+}
+
+} // namespace
+
+Utf8Index::Utf8Index(std::string_view text) {
+  const char *begin = text.data();
+  const char *end = begin + text.size();
+  const char *p = begin;
+  while (p < end) {
+    const size_t byte = static_cast<size_t>(p - begin);
+    if (codePoints_ % kStride == 0) {
+      byCodePoint_.push_back({byte, units_});
+    }
+    const size_t width = utf16Width(utils::decodeUtf8(p, end));
+    // 本码点占据的单元 [units_, units_ + width) 跨过路标位置时记录
+    if (units_ % kStride == 0 || (width == 2 && (units_ + 1) % kStride == 0)) {
+      byUnit_.push_back({byte, units_});
+    }
+    ++codePoints_;
+    units_ += width;
+  }
+  // 末尾位置同样可以定位
+  if (codePoints_ % kStride == 0) {
+    byCodePoint_.push_back({text.size(), units_});
+  }
+  if (units_ % kStride == 0) {
+    byUnit_.push_back({text.size(), units_});
+  }
+}
+
+Utf8Index::Position Utf8Index::codePoint(std::string_view text,
+                                         size_t index) const {
+  Position position = byCodePoint_[index / kStride];
+  const char *p = text.data() + position.byte;
+  const char *end = text.data() + text.size();
+  for (size_t i = index % kStride; i > 0; --i) {
+    position.unit += utf16Width(utils::decodeUtf8(p, end));
+  }
+  position.byte = static_cast<size_t>(p - text.data());
+  return position;
+}
+
+Utf8Index::Position Utf8Index::utf16Unit(std::string_view text,
+                                         size_t unit) const {
+  Position position = byUnit_[unit / kStride];
+  const char *end = text.data() + text.size();
+  while (position.byte < text.size()) {
+    const char *p = text.data() + position.byte;
+    const size_t width = utf16Width(utils::decodeUtf8(p, end));
+    if (position.unit + width > unit) {
+      break;
+    }
+    position.unit += width;
+    position.byte = static_cast<size_t>(p - text.data());
+  }
+  return position;
+}
+
+size_t Utf8Index::utf16Offset(std::string_view text, size_t byte) const {
+  auto it = std::upper_bound(
+      byCodePoint_.begin(), byCodePoint_.end(), byte,
+      [](size_t value, const Position &mark) { return value < mark.byte; });
+  const Position &mark = *(it - 1);
+  const char *p = text.data() + mark.byte;
+  const char *target = text.data() + byte;
+  const char *end = text.data() + text.size();
+  size_t unit = mark.unit;
+  while (p < target) {
+    const char *next = p;
+    const size_t width = utf16Width(utils::decodeUtf8(next, end));
+    if (next > target) {
+      break;
+    }
+    unit += width;
+    p = next;
+  }
+  return unit;
+}
+
+} // namespace jobject
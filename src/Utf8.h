@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jobject {
+
+namespace utils {
+
+// 是否全部为 ASCII 字节；SSE2 下每次检查 16 字节
+bool isAscii(std::string_view text);
+
+// 解码 p 处的一个码点并前移 p，要求 p < end。非法或截断的序列
+// 每个字节按一个 U+FFFD 处理
+uint32_t decodeUtf8(const char *&p, const char *end);
+
+// 把码点按 UTF-8 编码追加到 out
+void appendUtf8(std::string &out, uint32_t codePoint);
+
+} // namespace utils
+
+// 非 ASCII 字符串的码点与 UTF-16 下标索引。
+//
+// 每隔 kStride 个码点、每隔 kStride 个 UTF-16 单元记录一个路标
+// （该位置所在码点的字节偏移与 UTF-16 偏移），按下标定位时先直接取路标，
+// 再向后解码不超过 kStride 个码点，因此随机访问的代价有固定上界。
+// 按字节偏移反查 UTF-16 偏移时二分查找路标。
+class Utf8Index {
+public:
+  static constexpr size_t kStride = 64;
+
+  // 码点起始位置
+  struct Position {
+    size_t byte = 0;
+    size_t unit = 0; // UTF-16 偏移
+  };
+
+  explicit Utf8Index(std::string_view text);
+
+  size_t codePointCount() const { return codePoints_; }
+  size_t utf16Length() const { return units_; }
+
+  // 第 index 个码点的起始位置，要求 index <= codePointCount()
+  Position codePoint(std::string_view text, size_t index) const;
+  // 包含第 unit 个 UTF-16 单元的码点的起始位置，要求 unit <= utf16Length()
+  Position utf16Unit(std::string_view text, size_t unit) const;
+  // 字节偏移 byte 所在码点之前的 UTF-16 单元数，要求 byte <= text.size()
+  size_t utf16Offset(std::string_view text, size_t byte) const;
+
+private:
+  std::vector<Position> byCodePoint_; // [j] 为第 j * kStride 个码点
+  std::vector<Position> byUnit_;      // [j] 为包含第 j * kStride 个单元的码点
+  size_t codePoints_ = 0;
+  size_t units_ = 0;
+};
+
+} // namespace jobject
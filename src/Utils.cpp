@@ -3,6 +3,8 @@
 #include "Accessor.h"
 
 #include <cctype>
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -69,6 +71,75 @@ std::vector<std::string> parseExpressionTokens(const std::string &expression) {
   return tokens;
 }
 
+// 数值的规范形式：整数值（包括整数值的 double）精确地按整数表示，
+// 其余 double 原样保留。数学值相等的数值规范形式相同
+struct NumberKey {
+  enum class Kind : uint8_t { Negative, NonNegative, Fraction };
+
+  Kind kind;
+  uint64_t bits = 0; // Negative 时为 int64_t 的补码
+  double fraction = 0.0;
+
+  bool operator==(const NumberKey &other) const {
+    if (kind != other.kind) {
+      return false;
+    }
+    return kind == Kind::Fraction ? fraction == other.fraction
+                                  : bits == other.bits;
+  }
+
+  size_t hash() const {
+    return kind == Kind::Fraction ? std::hash<double>{}(fraction)
+                                  : std::hash<uint64_t>{}(bits);
+  }
+};
+
+NumberKey numberKey(int64_t value) {
+  return {value < 0 ? NumberKey::Kind::Negative : NumberKey::Kind::NonNegative,
+          static_cast<uint64_t>(value)};
+}
+
+NumberKey numberKey(uint64_t value) {
+  return {NumberKey::Kind::NonNegative, value};
+}
+
+NumberKey numberKey(double value) {
+  // 2^64 与 -2^63；-0 归入 0
+  if (std::trunc(value) == value) {
+    if (value >= 0 && value < 18446744073709551616.0) {
+      return numberKey(static_cast<uint64_t>(value));
+    }
+    if (value < 0 && value >= -9223372036854775808.0) {
+      return numberKey(static_cast<int64_t>(value));
+    }
+  }
+  return {NumberKey::Kind::Fraction, 0, value};
+}
+
+NumberKey numberKey(const ValueVariant &value) {
+  return std::visit(
+      [](const auto &v) -> NumberKey {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, int32_t>) {
+          return numberKey(static_cast<int64_t>(v));
+        } else if constexpr (std::is_same_v<T, uint32_t> ||
+                             std::is_same_v<T, uint64_t>) {
+          return numberKey(static_cast<uint64_t>(v));
+        } else if constexpr (std::is_same_v<T, double>) {
+          return numberKey(v);
+        } else {
+          return {NumberKey::Kind::Fraction, 0, std::nan("")};
+        }
+      },
+      value);
+}
+
+// 非数值类型的哈希种子，避免 undefined、null、false 等彼此碰撞
+constexpr size_t kUndefinedHash = 0x9e3779b97f4a7c15ull;
+constexpr size_t kNullHash = 0xc2b2ae3d27d4eb4full;
+constexpr size_t kTrueHash = 0x165667b19e3779f9ull;
+constexpr size_t kFalseHash = 0x27d4eb2f165667c5ull;
+
 } // namespace
 
 namespace utils {
@@ -116,6 +187,133 @@ jvalue evalValue(jvalue value, const std::string &expr) {
   return current;
 }
 
+CompiledPath::CompiledPath(const std::string &expr) {
+  const auto tokens = parseExpressionTokens(expr);
+  steps_.reserve(tokens.size());
+  for (const auto &token : tokens) {
+    Step step;
+    step.name = Atom::intern(token);
+    bool isIndexToken = !token.empty();
+    for (const auto ch : token) {
+      if (!std::isdigit(static_cast<unsigned char>(ch))) {
+        isIndexToken = false;
+        break;
+      }
+    }
+    if (isIndexToken) {
+      try {
+        step.index = static_cast<size_t>(std::stoull(token));
+        step.indexKind = IndexKind::Valid;
+      } catch (const std::exception &) {
+        step.indexKind = IndexKind::Overflow;
+      }
+    }
+    steps_.push_back(std::move(step));
+  }
+}
+
+jvalue CompiledPath::evalProperty(const Step &step, JObject *object) const {
+  const auto &shape = object->shape_;
+  if (shape && shape == step.cachedShape) {
+    return jvalue(object->getSlotValue(step.cachedSlot), object, step.name);
+  }
+
+  // 未命中：走常规查找，并在属性为未被拦截的自有属性时刷新缓存
+  jvalue result(object->getProperty(step.name), object, step.name);
+  if (shape && !object->interceptsProperty(step.name.str())) {
+    const uint32_t slot = shape->lookup(step.name);
+    if (slot != Shape::kNotFound) {
+      step.cachedShape = shape;
+      step.cachedSlot = slot;
+    }
+  }
+  return result;
+}
+
+jvalue CompiledPath::eval(const jvalue &value) const {
+  jvalue current = value;
+
+  for (const auto &step : steps_) {
+    if (current.isNullish()) {
+      return jvalue(JUndefined{});
+    }
+
+    const auto currentType = getValueType(current.getValue());
+    if (currentType == ValueType::Array &&
+        step.indexKind != IndexKind::None) {
+      if (step.indexKind == IndexKind::Overflow) {
+        return jvalue(JUndefined{});
+      }
+      current = current[step.index];
+    } else if (currentType == ValueType::Array ||
+               currentType == ValueType::Object ||
+               currentType == ValueType::String ||
+               currentType == ValueType::Function ||
+               currentType == ValueType::Date) {
+      current = evalProperty(step, current.getObjectLike());
+    } else {
+      return jvalue(JUndefined{});
+    }
+  }
+
+  return current;
+}
+
+CompiledPath compilePath(const std::string &expr) { return CompiledPath(expr); }
+
+jvalue evalValue(jvalue value, const CompiledPath &path) {
+  return path.eval(value);
+}
+
+bool strictEquals(const ValueVariant &a, const ValueVariant &b) {
+  if (a.index() != b.index()) {
+    // 不同存储类型的数值按数学值比较
+    return isNumber(a) && isNumber(b) && numberKey(a) == numberKey(b);
+  }
+  return std::visit(
+      [&b](const auto &v) -> bool {
+        using T = std::decay_t<decltype(v)>;
+        const T &other = std::get<T>(b);
+        if constexpr (std::is_same_v<T, JUndefined> ||
+                      std::is_same_v<T, std::nullptr_t>) {
+          return true;
+        } else if constexpr (std::is_same_v<T, Ref<JString>>) {
+          if (!v || !other) {
+            return v == other;
+          }
+          return v->Equals(*other);
+        } else {
+          // 同类型数值直接比较（NaN 不等于自身，+0 等于 -0）；其余按引用
+          return v == other;
+        }
+      },
+      a);
+}
+
+size_t hashValue(const ValueVariant &value) {
+  return std::visit(
+      [&value](const auto &v) -> size_t {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, JUndefined>) {
+          return kUndefinedHash;
+        } else if constexpr (std::is_same_v<T, std::nullptr_t>) {
+          return kNullHash;
+        } else if constexpr (std::is_same_v<T, bool>) {
+          return v ? kTrueHash : kFalseHash;
+        } else if constexpr (std::is_same_v<T, int32_t> ||
+                             std::is_same_v<T, uint32_t> ||
+                             std::is_same_v<T, uint64_t> ||
+                             std::is_same_v<T, double>) {
+          return numberKey(value).hash();
+        } else if constexpr (std::is_same_v<T, Ref<JString>>) {
+          return v ? v->Hash() : 0;
+        } else {
+          return std::hash<const void *>{}(v.get());
+        }
+      },
+      value);
+}
+
 } // namespace utils
 
 } // namespace jobject
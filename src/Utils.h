@@ -76,14 +76,94 @@ double toNumber(const ValueVariant &value);
 bool toBoolean(const ValueVariant &value);
 jvalue evalValue(jvalue value, const std::string &expr);
 
+/**
+ * @brief Compare two values with JavaScript strict equality (===).
+ *
+ * Numbers compare by mathematical value regardless of their stored type,
+ * so int32_t 1, uint64_t 1 and 1.0 are equal; NaN is unequal to itself
+ * and +0 equals -0. Strings compare by contents, using the cached hashes
+ * to reject most mismatches and pointer identity for interned strings.
+ * Objects, arrays, functions and dates compare by reference.
+ */
+bool strictEquals(const ValueVariant &a, const ValueVariant &b);
+
+/**
+ * @brief Hash a value consistently with strictEquals.
+ *
+ * Strictly equal values hash equally. Strings use the content hash
+ * cached on the JString, so each string is hashed at most once until it
+ * is modified.
+ */
+size_t hashValue(const ValueVariant &value);
+
+// 以严格相等为键比较的哈希表所用的函数对象，如
+// std::unordered_map<ValueVariant, T, utils::ValueHash, utils::ValueEqual>
+struct ValueHash {
+  size_t operator()(const ValueVariant &value) const {
+    return hashValue(value);
+  }
+};
+
+struct ValueEqual {
+  bool operator()(const ValueVariant &a, const ValueVariant &b) const {
+    return strictEquals(a, b);
+  }
+};
+
+// 预编译的属性路径（如 "a.b[3].c"）。表达式只解析一次，每一步缓存上次遇到的
+// Shape 与对应槽位（单态内联缓存），同形对象上的求值直接按槽位读取，
+// 未命中时回退到常规属性查找并更新缓存。
+// 缓存在求值时更新，同一实例不可被多个线程并发使用。
+class CompiledPath {
+public:
+  explicit CompiledPath(const std::string &expr);
+
+  jvalue eval(const jvalue &value) const;
+
+private:
+  enum class IndexKind { None, Valid, Overflow };
+
+  struct Step {
+    Atom name;
+    IndexKind indexKind = IndexKind::None;
+    size_t index = 0;
+    mutable std::shared_ptr<const Shape> cachedShape;
+    mutable uint32_t cachedSlot = Shape::kNotFound;
+  };
+
+  jvalue evalProperty(const Step &step, JObject *object) const;
+
+  std::vector<Step> steps_;
+};
+
+CompiledPath compilePath(const std::string &expr);
+jvalue evalValue(jvalue value, const CompiledPath &path);
+
 // 创建不同类型的值
-std::shared_ptr<JObject> createObject();
-std::shared_ptr<JString> createString(const std::string &str = "");
-std::shared_ptr<JArray> createArray(size_t size = 0);
-std::shared_ptr<JFunction>
+Ref<JObject> createObject();
+Ref<JString> createString(const std::string &str = "");
+// intern 为 true 时返回驻留字符串（见 internString）
+Ref<JString> createString(const std::string &str, bool intern);
+Ref<JArray> createArray(size_t size = 0);
+Ref<JFunction>
 createFunction(const std::string &name = "",
                JFunction::FunctionType func = nullptr);
-std::shared_ptr<JDate> createDate();
+Ref<JDate> createDate();
+
+/**
+ * @brief Return the canonical interned JString with the given contents.
+ *
+ * Equal contents always yield the same object while any reference to it
+ * is alive, so repeated values share one allocation and interned strings
+ * compare equal exactly when they are the same pointer. The table holds
+ * no references: an interned string is removed when it is released.
+ * Interned strings are immutable; setValue and Clear on them return false
+ * and leave the contents unchanged. Safe to call from multiple threads.
+ *
+ * @param[in] str The string contents.
+ * @return The shared interned string.
+ */
+Ref<JString> internString(std::string_view str);
 
 // 实现部分
 inline ValueType getValueType(const ValueVariant &value) {
@@ -104,15 +184,15 @@ inline ValueType getValueType(const ValueVariant &value) {
           return ValueType::UInt64;
         } else if constexpr (std::is_same_v<T, double>) {
           return ValueType::Double;
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JString>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JString>>) {
           return ValueType::String;
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JArray>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JArray>>) {
           return ValueType::Array;
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JObject>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JObject>>) {
           return ValueType::Object;
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JFunction>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JFunction>>) {
           return ValueType::Function;
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JDate>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JDate>>) {
           return ValueType::Date;
         }
         return ValueType::Null;
@@ -138,15 +218,15 @@ inline std::string valueToString(const ValueVariant &value) {
           return std::to_string(v);
         } else if constexpr (std::is_same_v<T, double>) {
           return std::to_string(v);
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JString>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JString>>) {
           return v ? v->toString() : "null";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JArray>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JArray>>) {
           return v ? v->toString() : "null";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JObject>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JObject>>) {
           return v ? v->toString() : "null";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JFunction>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JFunction>>) {
           return v ? v->toString() : "null";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JDate>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JDate>>) {
           return v ? v->toString() : "null";
         }
         return "undefined";
@@ -207,7 +287,7 @@ inline bool toBoolean(const ValueVariant &value) {
           return v != 0;
         } else if constexpr (std::is_same_v<T, double>) {
           return v != 0.0 && !std::isnan(v);
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<JString>>) {
+        } else if constexpr (std::is_same_v<T, Ref<JString>>) {
           return v && !v->Empty();
         } else {
           return v != nullptr;
@@ -216,56 +296,60 @@ inline bool toBoolean(const ValueVariant &value) {
       value);
 }
 
-inline std::shared_ptr<JObject> createObject() {
-  return std::make_shared<JObject>();
+inline Ref<JObject> createObject() {
+  return makeRef<JObject>();
+}
+
+inline Ref<JString> createString(const std::string &str) {
+  return makeRef<JString>(str);
 }
 
-inline std::shared_ptr<JString> createString(const std::string &str) {
-  return std::make_shared<JString>(str);
+inline Ref<JString> createString(const std::string &str, bool intern) {
+  return intern ? internString(str) : makeRef<JString>(str);
 }
 
-inline std::shared_ptr<JArray> createArray(size_t size) {
-  return std::make_shared<JArray>(size);
+inline Ref<JArray> createArray(size_t size) {
+  return makeRef<JArray>(size);
 }
 
-inline std::shared_ptr<JFunction> createFunction(const std::string &name,
+inline Ref<JFunction> createFunction(const std::string &name,
                                                  JFunction::FunctionType func) {
-  return std::make_shared<JFunction>(name, func);
+  return makeRef<JFunction>(name, func);
 }
 
-inline std::shared_ptr<JDate> createDate() { return std::make_shared<JDate>(); }
+inline Ref<JDate> createDate() { return makeRef<JDate>(); }
 
 // Conversion utilities
-inline std::shared_ptr<JArray> toJArray(const ValueVariant &value) {
-  if (auto arrayPtr = std::get_if<std::shared_ptr<JArray>>(&value)) {
+inline Ref<JArray> toJArray(const ValueVariant &value) {
+  if (auto arrayPtr = std::get_if<Ref<JArray>>(&value)) {
     return *arrayPtr;
   }
   return nullptr;
 }
 
-inline std::shared_ptr<JString> toJString(const ValueVariant &value) {
-  if (auto stringPtr = std::get_if<std::shared_ptr<JString>>(&value)) {
+inline Ref<JString> toJString(const ValueVariant &value) {
+  if (auto stringPtr = std::get_if<Ref<JString>>(&value)) {
     return *stringPtr;
   }
   return nullptr;
 }
 
-inline std::shared_ptr<JObject> toJObject(const ValueVariant &value) {
-  if (auto objectPtr = std::get_if<std::shared_ptr<JObject>>(&value)) {
+inline Ref<JObject> toJObject(const ValueVariant &value) {
+  if (auto objectPtr = std::get_if<Ref<JObject>>(&value)) {
     return *objectPtr;
   }
   return nullptr;
 }
 
-inline std::shared_ptr<JFunction> toJFunction(const ValueVariant &value) {
-  if (auto functionPtr = std::get_if<std::shared_ptr<JFunction>>(&value)) {
+inline Ref<JFunction> toJFunction(const ValueVariant &value) {
+  if (auto functionPtr = std::get_if<Ref<JFunction>>(&value)) {
     return *functionPtr;
   }
   return nullptr;
 }
 
-inline std::shared_ptr<JDate> toJDate(const ValueVariant &value) {
-  if (auto datePtr = std::get_if<std::shared_ptr<JDate>>(&value)) {
+inline Ref<JDate> toJDate(const ValueVariant &value) {
+  if (auto datePtr = std::get_if<Ref<JDate>>(&value)) {
     return *datePtr;
   }
   return nullptr;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+
+#include "Ref.h"
+
+namespace jobject {
+
+// 前向声明
+class JObject;
+class JString;
+class JArray;
+class JFunction;
+class JDate;
+class jvalue;
+
+namespace utils {
+class CompiledPath;
+class JSONParser;
+}
+
+// undefined 标签类型（零开销空结构体，区分 JS 的 undefined 与 null）
+struct JUndefined {
+  bool operator==(const JUndefined &) const { return true; }
+};
+
+// 全局 undefined 常量（可写 jobject::undefined）
+inline constexpr JUndefined undefined{};
+
+// 值类型枚举
+enum class ValueType {
+  Undefined,
+  Null,
+  Boolean,
+  Int32,
+  UInt32,
+  UInt64,
+  Double,
+  String,
+  Array,
+  Object,
+  Function,
+  Date
+};
+
+// 值的变体类型
+using ValueVariant = std::variant<JUndefined,               // Undefined
+                                  std::nullptr_t,           // Null
+                                  bool,                     // Boolean
+                                  int32_t,                  // Int32
+                                  uint32_t,                 // UInt32
+                                  uint64_t,                 // UInt64
+                                  double,                   // Double
+                                  Ref<JString>,             // String
+                                  Ref<JArray>,              // Array
+
+                                  Ref<JObject>,             // Object
+                                  Ref<JFunction>,           // Function
+                                  Ref<JDate>                // Date
+                                  >;
+
+} // namespace jobject
@@ -1,6 +1,14 @@
 #include "../src/JObject.h"
+#include "../src/BuiltinTable.h"
+#include "../src/StringTable.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <stdexcept>
 #include <cassert>
+#include <thread>
+#include <unordered_map>
 
 using namespace jobject;
 using namespace jobject::utils;
@@ -25,6 +33,67 @@ void testBasicTypes() {
     std::cout << "double: " << valueToString(doubleValue) << std::endl;
 }
 
+void testCompactValue() {
+    std::cout << "\n=== 测试紧凑值 ===" << std::endl;
+
+    const std::vector<ValueVariant> values = {
+        JUndefined{}, nullptr, true, false,
+        static_cast<int32_t>(-5), static_cast<uint32_t>(4000000000u),
+        static_cast<uint64_t>(42), static_cast<uint64_t>(UINT64_MAX),
+        -0.5, std::nan(""), createString("boxed"), createArray(2)};
+    for (const auto& value : values) {
+        CompactValue compact(value);
+        CompactValue copy = compact;
+        assert(compact.type() == getValueType(value));
+        assert(valueToString(copy.toVariant()) == valueToString(value));
+    }
+    std::cout << "CompactValue 大小: " << sizeof(CompactValue) << " 字节" << std::endl;
+
+    auto str = createString("shared");
+    {
+        CompactValue a{ValueVariant(str)};
+        CompactValue b = a;
+        assert(std::get<Ref<JString>>(b.toVariant()) == str);
+    }
+    assert(str.use_count() == 1);
+
+    // 以 Object 备选类型保存的字符串仍按 Object 取回
+    ValueVariant asObject = Ref<JObject>(str);
+    CompactValue compactObject(asObject);
+    assert(compactObject.type() == ValueType::Object);
+    assert(std::get<Ref<JObject>>(compactObject.toVariant()) == str);
+}
+
+void testRef() {
+    std::cout << "\n=== 测试侵入式引用计数 ===" << std::endl;
+
+    static_assert(sizeof(Ref<JObject>) == sizeof(void*), "Ref 只占一个指针");
+
+    auto arr = createArray();
+    assert(arr.use_count() == 1);
+    {
+        Ref<JObject> base = arr;
+        assert(arr.use_count() == 2);
+        auto back = static_pointer_cast<JArray>(base);
+        assert(back == arr && arr.use_count() == 3);
+        assert(!dynamic_pointer_cast<JString>(base));
+    }
+    assert(arr.use_count() == 1);
+
+    // 计数保存在对象内部，可由裸指针重新得到句柄
+    Ref<JArray> again(arr.get());
+    assert(arr.use_count() == 2);
+    again.reset();
+
+    // 绑定到元素的 jvalue 持有目标数组，写回始终有效
+    jvalue element = jvalue(arr)[2];
+    auto* raw = arr.get();
+    arr.reset();
+    element = static_cast<int32_t>(7);
+    assert(raw->Size() == 3);
+    std::cout << "Ref 大小: " << sizeof(Ref<JObject>) << " 字节" << std::endl;
+}
+
 void testString() {
     std::cout << "\n=== 测试字符串 ===" << std::endl;
     
@@ -33,17 +102,379 @@ void testString() {
     std::cout << "长度: " << valueToString(str->getProperty("length")) << std::endl;
     
     // 测试concat
-    auto concatFunc = std::get<std::shared_ptr<JFunction>>(str->getProperty("concat"));
+    auto concatFunc = std::get<Ref<JFunction>>(str->getProperty("concat"));
     auto result = concatFunc->Call({createString(" - 测试")});
-    auto resultStr = std::get<std::shared_ptr<JString>>(result);
+    auto resultStr = std::get<Ref<JString>>(result);
     std::cout << "concat结果: " << resultStr->toString() << std::endl;
     
     // 测试indexOf
-    auto indexOfFunc = std::get<std::shared_ptr<JFunction>>(str->getProperty("indexOf"));
+    auto indexOfFunc = std::get<Ref<JFunction>>(str->getProperty("indexOf"));
     auto indexResult = indexOfFunc->Call({createString("World")});
     std::cout << "indexOf 'World': " << valueToString(indexResult) << std::endl;
 }
 
+void testRopeString() {
+    std::cout << "\n=== 测试字符串拼接链 ===" << std::endl;
+
+    // 逐段拼接：长度无需展平即可得到，首次读取内容时展平
+    const std::string piece = "0123456789abcdef";
+    auto base = createString(piece);
+    auto text = base;
+    std::string expected = piece;
+    auto concat = std::get<Ref<JFunction>>(base->getProperty("concat"));
+    ValueVariant pieceValue = createString(piece);
+    for (int i = 0; i < 100; ++i) {
+        text = text->Concat(&pieceValue, 1);
+        expected += piece;
+    }
+    assert(text->Size() == expected.size());
+    assert(std::get<uint32_t>(text->getProperty("length")) == expected.size());
+    assert(text->getValue() == expected);
+    assert(text->At(17) == '1' && text->Back() == 'f');
+
+    // 参数不是字符串时按字符串形式拼接；子串拼接后仍可独立读取
+    auto mixed = std::get<Ref<JString>>(concat->Call({static_cast<int32_t>(42), true}));
+    assert(mixed->getValue() == expected.substr(0, 16) + "42true");
+    auto indexOf = std::get<Ref<JFunction>>(text->getProperty("indexOf"));
+    auto twice = text->Concat(&pieceValue, 1);
+    assert(twice->getValue() == expected + piece);
+    assert(std::get<int32_t>(indexOf->Call({createString("f0")})) == 15);
+
+    // 拼接结果修改后不再引用原来的各段
+    twice->setValue("reset");
+    assert(twice->Size() == 5 && twice->toString() == "reset");
+
+    // 拼接结果是各段的快照：之后修改参与拼接的字符串不影响结果
+    auto head = createString(std::string(300, 'x'));
+    auto tail = createString("y");
+    ValueVariant tailValue = tail;
+    auto joined = head->Concat(&tailValue, 1);
+    ValueVariant joinedValue = joined;
+    auto outer = createString(std::string(40, 'w'))->Concat(&joinedValue, 1);
+    head->setValue("z");
+    tail->Clear();
+    joined->setValue("rewritten");
+    assert(outer->Size() == 341 && outer->getValue() == std::string(40, 'w') + std::string(300, 'x') + "y");
+    assert(head->getValue() == "z" && joined->Size() == 9);
+
+    // 很长的拼接链：展平与析构都不递归
+    auto chain = createString(std::string(300, 'x'));
+    ValueVariant dot = createString(".");
+    for (int i = 0; i < 200000; ++i) {
+        chain = chain->Concat(&dot, 1);
+    }
+    assert(chain->Size() == 200300);
+    auto longer = chain->Concat(&dot, 1);
+    chain.reset();
+    assert(longer->getValue().size() == 200301 && longer->Back() == '.');
+    longer.reset();
+    auto unread = createString(std::string(300, 'y'));
+    for (int i = 0; i < 200000; ++i) {
+        unread = unread->Concat(&dot, 1);
+    }
+    unread.reset();
+    std::cout << "拼接链长度: " << expected.size() << std::endl;
+}
+
+void testSubstring() {
+    std::cout << "\n=== 测试子串 ===" << std::endl;
+
+    std::string csv;
+    for (int i = 0; i < 100; ++i) {
+        csv += "field-" + std::to_string(i) + "-with-a-long-enough-payload,";
+    }
+    csv.pop_back();
+    auto input = createString(csv);
+
+    // 较长的子串与原字符串共享字节，较短的直接复制
+    auto middle = input->Substring(10, 200);
+    assert(middle->Size() == 190 && middle->view() == std::string_view(csv).substr(10, 190));
+    assert(middle->view().data() == input->view().data() + 10);
+    auto nested = middle->Substring(5, 100);
+    assert(nested->view().data() == input->view().data() + 15);
+    auto tiny = input->Substring(0, 5);
+    assert(tiny->view() == "field" && tiny->view().data() != input->view().data());
+    assert(middle->getValue() == csv.substr(10, 190));
+    assert(middle->At(0) == csv[10] && middle->Back() == csv[199]);
+
+    // 切分得到的各段同样共享字节
+    auto fields = input->Split(",");
+    assert(fields->Size() == 100);
+    auto first = std::get<Ref<JString>>(fields->At(0));
+    assert(first->view() == "field-0-with-a-long-enough-payload");
+    assert(first->view().data() == input->view().data());
+    assert(input->Split(",", 3)->Size() == 3);
+    assert(createString("abc")->Split("")->toString() == "a,b,c");
+    assert(createString("a,,b")->Split(",")->Size() == 3);
+
+    // 修改原字符串后，已有的子串内容不变
+    input->setValue("replaced");
+    assert(first->view() == "field-0-with-a-long-enough-payload");
+    assert(middle->view() == std::string_view(csv).substr(10, 190));
+    assert(input->toString() == "replaced");
+
+    // 原字符串修改后不再持有旧字节：只剩子串引用时，从中取出的小片段不再共享
+    auto reused = createString(csv);
+    auto kept = reused->Substring(0, 1000);
+    reused->setValue(csv);
+    auto copied = kept->Substring(0, 64);
+    assert(copied->view() == std::string_view(csv).substr(0, 64));
+    assert(copied->view().data() != kept->view().data());
+
+    // 反复改写同一个字符串并切分：旧内容随其最后一个子串释放
+    auto buffer = createString();
+    for (int i = 0; i < 2000; ++i) {
+        buffer->setValue(csv + std::to_string(i));
+        auto tokens = buffer->Split(",");
+        assert(tokens->Size() == 100);
+    }
+
+    // 只剩子串引用原内容时，从中取出的小片段不再共享
+    input.reset();
+    fields = createArray();
+    first.reset();
+    nested.reset();
+    auto piece = middle->Substring(0, 32);
+    assert(middle->view().substr(0, 32) == piece->view());
+    assert(piece->view().data() != middle->view().data());
+
+    // 内置方法
+    auto text = createString("The quick brown fox jumps over the lazy dog, twice over");
+    auto call = [&](const char *name, std::vector<ValueVariant> args) {
+        return std::get<Ref<JFunction>>(text->getProperty(name))->Call(args);
+    };
+    assert(valueToString(call("substring", {static_cast<int32_t>(10), static_cast<int32_t>(4)})) == "quick ");
+    assert(valueToString(call("slice", {static_cast<int32_t>(-4)})) == "over");
+    assert(valueToString(call("slice", {static_cast<int32_t>(4), static_cast<int32_t>(-4)})).size() == text->Size() - 8);
+    auto words = std::get<Ref<JArray>>(call("split", {createString(" "), static_cast<int32_t>(2)}));
+    assert(words->toString() == "The,quick");
+    assert(std::get<Ref<JArray>>(call("split", {}))->Size() == 1);
+    assert(stringify(call("substring", {static_cast<int32_t>(4)})) ==
+           "\"quick brown fox jumps over the lazy dog, twice over\"");
+    std::cout << "split 结果: " << words->toString() << std::endl;
+}
+
+void testStringSearch() {
+    std::cout << "\n=== 测试子串查找 ===" << std::endl;
+
+    // 与 std::string_view 的结果逐一比对；小字母表制造大量部分匹配
+    uint32_t seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 16;
+    };
+    size_t checks = 0;
+    for (int round = 0; round < 300; ++round) {
+        std::string haystack(next() % 200, ' ');
+        for (char &ch : haystack) ch = "aab\x80"[next() % 4];
+        std::string needle(next() % 40, ' ');
+        for (char &ch : needle) ch = "aab\x80"[next() % 4];
+        if (round % 3 == 0 && haystack.size() > needle.size()) {
+            haystack.replace(next() % (haystack.size() - needle.size()), needle.size(), needle);
+        }
+        const std::string_view text = haystack;
+        const StringSearcher searcher(needle);
+        for (size_t from = 0; from <= haystack.size() + 1; from += 1 + next() % 7) {
+            assert(indexOf(text, needle, from) == text.find(needle, from));
+            assert(lastIndexOf(text, needle, from) == text.rfind(needle, from));
+            assert(searcher.find(text, from) == text.find(needle, from));
+            assert(searcher.rfind(text, from) == text.rfind(needle, from));
+            ++checks;
+        }
+        assert(searcher.rfind(text) == text.rfind(needle));
+    }
+
+    // 内置方法：字符串参数不经转换，支持起始位置
+    auto text = createString("error: disk full; error: retry; error: give up");
+    auto indexOfFunc = std::get<Ref<JFunction>>(text->getProperty("indexOf"));
+    auto lastIndexOfFunc = std::get<Ref<JFunction>>(text->getProperty("lastIndexOf"));
+    assert(std::get<int32_t>(indexOfFunc->Call({createString("error")})) == 0);
+    assert(std::get<int32_t>(indexOfFunc->Call({createString("error"), static_cast<int32_t>(1)})) == 18);
+    assert(std::get<int32_t>(lastIndexOfFunc->Call({createString("error")})) == 32);
+    assert(std::get<int32_t>(lastIndexOfFunc->Call({createString("error"), static_cast<int32_t>(31)})) == 18);
+    assert(std::get<int32_t>(indexOfFunc->Call({createString("fatal")})) == -1);
+    assert(std::get<int32_t>(indexOfFunc->Call({static_cast<int32_t>(42)})) == -1);
+    assert(text->IndexOf("retry") == 25 && text->LastIndexOf("") == text->Size());
+    std::cout << "比对次数: " << checks << std::endl;
+}
+
+void testUnicodeString() {
+    std::cout << "\n=== 测试 Unicode 字符串 ===" << std::endl;
+
+    // "héllo 世界 😀"：é 两字节，汉字三字节，表情四字节（UTF-16 中为代理对）
+    auto text = createString("h\xC3\xA9llo \xE4\xB8\x96\xE7\x95\x8C \xF0\x9F\x98\x80");
+    assert(!text->IsAscii());
+    assert(text->Size() == 18 && text->CodePointLength() == 10 && text->Utf16Length() == 11);
+    assert(std::get<uint32_t>(text->getProperty("length")) == 11);
+    assert(text->CodePointAt(1) == 0xE9 && text->CodePointAt(6) == 0x4E16);
+    assert(text->CodePointAt(9) == 0x1F600 && text->CodePointAt(10) == 0);
+    assert(text->Utf16At(9) == 0xD83D && text->Utf16At(10) == 0xDE00);
+    assert(text->Utf16ToByteOffset(6) == 7 && text->ByteToUtf16Offset(10) == 7);
+    assert(text->Utf16ToByteOffset(10) == 14 && text->Utf16ToByteOffset(99) == 18);
+
+    // 内置方法按 UTF-16 单元计
+    auto call = [&](const char *name, std::vector<ValueVariant> args) {
+        return std::get<Ref<JFunction>>(text->getProperty(name))->Call(args);
+    };
+    assert(valueToString(call("substring", {static_cast<int32_t>(6), static_cast<int32_t>(8)})) ==
+           "\xE4\xB8\x96\xE7\x95\x8C");
+    assert(valueToString(call("slice", {static_cast<int32_t>(-2)})) == "\xF0\x9F\x98\x80");
+    assert(valueToString(call("charAt", {static_cast<int32_t>(1)})) == "\xC3\xA9");
+    assert(std::get<int32_t>(call("charCodeAt", {static_cast<int32_t>(10)})) == 0xDE00);
+    assert(std::get<int32_t>(call("codePointAt", {static_cast<int32_t>(9)})) == 0x1F600);
+    assert(std::holds_alternative<JUndefined>(call("codePointAt", {static_cast<int32_t>(11)})));
+    assert(std::get<int32_t>(call("indexOf", {createString("\xE7\x95\x8C")})) == 7);
+    assert(std::get<int32_t>(call("lastIndexOf", {createString("l")})) == 3);
+    assert(std::get<int32_t>(call("indexOf", {createString("l"), static_cast<int32_t>(4)})) == -1);
+    assert(createString("a\xC3\xA9" "b")->Split("")->Size() == 3);
+
+    // 长字符串的随机访问经由路标索引，与逐个解码的结果一致
+    std::string longText;
+    std::vector<uint32_t> expected;
+    for (int i = 0; i < 5000; ++i) {
+        const uint32_t codePoint = i % 3 == 0 ? 'a' + i % 26 : (i % 3 == 1 ? 0x4E00 + i : 0x1F300 + i % 512);
+        appendUtf8(longText, codePoint);
+        expected.push_back(codePoint);
+    }
+    auto longString = createString(longText);
+    assert(longString->CodePointLength() == expected.size());
+    for (size_t i = 0; i < expected.size(); i += 7) {
+        assert(longString->CodePointAt(i) == expected[i]);
+    }
+    size_t unit = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const bool pair = expected[i] >= 0x10000;
+        const char16_t code = longString->Utf16At(unit);
+        assert(pair ? code == 0xD800 + ((expected[i] - 0x10000) >> 10) : code == expected[i]);
+        unit += pair ? 2 : 1;
+    }
+    assert(unit == longString->Utf16Length());
+
+    // ASCII 检测：拼接与子串由各段推出；非法字节按 U+FFFD 计
+    auto ascii = createString(std::string(300, 'x'));
+    assert(ascii->IsAscii() && ascii->Utf16Length() == 300);
+    ValueVariant accent = createString("\xC3\xA9");
+    auto mixed = ascii->Concat(&accent, 1);
+    assert(!mixed->IsAscii() && mixed->CodePointLength() == 301);
+    assert(ascii->Substring(10, 100)->IsAscii());
+    auto invalid = createString("a\xFF\xC3");
+    assert(invalid->CodePointLength() == 3 && invalid->CodePointAt(1) == 0xFFFD);
+    invalid->setValue("plain");
+    assert(invalid->IsAscii() && invalid->Utf16Length() == 5);
+    std::cout << "码点数: " << text->CodePointLength() << ", UTF-16 长度: " << text->Utf16Length() << std::endl;
+}
+
+void testStringIntern() {
+    std::cout << "\n=== 测试字符串驻留 ===" << std::endl;
+
+    const size_t before = StringTable::size();
+    auto ok = internString("OK");
+    auto again = createString("OK", true);
+    assert(ok.get() == again.get() && ok->refCount() == 2);
+    assert(createString("OK").get() != ok.get());
+    assert(StringTable::find("OK").get() == ok.get());
+    assert(StringTable::size() == before + 1);
+
+    // 表不持有引用：最后一个引用释放后条目随之移除
+    ok.reset();
+    again.reset();
+    assert(!StringTable::find("OK") && StringTable::size() == before);
+
+    // 驻留字符串为所有持有者共享，不可修改
+    auto code = internString("CN");
+    auto alias = internString("CN");
+    assert(!code->setValue("US") && !code->Clear());
+    assert(alias->view() == "CN" && StringTable::find("CN").get() == code.get());
+    assert(!StringTable::find("US"));
+    auto copy = createString("CN");
+    assert(copy->setValue("US") && copy->view() == "US");
+
+    // 解析时驻留字符串值，重复的值共享同一个对象
+    JSONParseOptions options;
+    options.internStrings = true;
+    auto rows = std::get<Ref<JArray>>(parseJSON(
+        R"([{"status":"OK","country":"CN"},{"status":"OK","country":"US"}])", options));
+    auto first = std::get<Ref<JObject>>(rows->At(0));
+    auto second = std::get<Ref<JObject>>(rows->At(1));
+    assert(std::get<Ref<JString>>(first->getProperty("status")).get() ==
+           std::get<Ref<JString>>(second->getProperty("status")).get());
+    auto plain = std::get<Ref<JArray>>(parseJSON(R"(["OK","OK"])"));
+    assert(std::get<Ref<JString>>(plain->At(0)).get() != std::get<Ref<JString>>(plain->At(1)).get());
+
+    // 多线程同时驻留与释放相同的值
+    std::vector<std::thread> threads;
+    std::atomic<bool> mismatch{false};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&mismatch]() {
+            for (int i = 0; i < 20000; ++i) {
+                const std::string value = "v" + std::to_string(i % 64);
+                auto a = internString(value);
+                auto b = internString(value);
+                if (a.get() != b.get() || a->view() != value) mismatch = true;
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    assert(!mismatch);
+    rows.reset();
+    first.reset();
+    second.reset();
+    code.reset();
+    alias.reset();
+    assert(StringTable::size() == before);
+    std::cout << "驻留表条目: " << StringTable::size() << std::endl;
+}
+
+void testValueEquality() {
+    std::cout << "\n=== 测试值的严格相等与哈希 ===" << std::endl;
+
+    // 哈希在首次使用时缓存，修改内容后重新计算
+    auto text = createString("group-by key");
+    const size_t hash = text->Hash();
+    assert(hash == text->Hash() && hash == createString("group-by key")->Hash());
+    text->setValue("another key");
+    assert(text->Hash() == createString("another key")->Hash());
+    text->Clear();
+    assert(text->Hash() == createString("")->Hash());
+
+    // 拼接与子串按内容比较
+    std::string long_text(300, 'x');
+    auto whole = createString(long_text + "tail");
+    ValueVariant parts[] = {createString(long_text), createString("tail")};
+    auto rope = createString()->Concat(parts, 2);
+    auto slice = createString("head" + long_text + "tail")->Substring(4, 308);
+    assert(strictEquals(whole, rope) && strictEquals(rope, slice));
+    assert(hashValue(whole) == hashValue(rope) && hashValue(rope) == hashValue(slice));
+    assert(!strictEquals(whole, createString(long_text + "tall")));
+
+    // 数值按数学值比较，不同存储类型的相等值哈希相同
+    assert(strictEquals(int32_t(1), 1.0) && strictEquals(uint64_t(7), uint32_t(7)));
+    assert(hashValue(int32_t(1)) == hashValue(1.0) && hashValue(uint64_t(7)) == hashValue(uint32_t(7)));
+    assert(strictEquals(0.0, -0.0) && hashValue(0.0) == hashValue(-0.0) && strictEquals(int32_t(0), -0.0));
+    assert(!strictEquals(std::nan(""), std::nan("")));
+    assert(!strictEquals(uint64_t(9007199254740993ull), 9007199254740992.0));
+    assert(strictEquals(int32_t(-5), -5.0) && !strictEquals(int32_t(-5), uint32_t(5)));
+    assert(!strictEquals(int32_t(1), true) && !strictEquals(createString("1"), int32_t(1)));
+    assert(strictEquals(JUndefined{}, JUndefined{}) && !strictEquals(JUndefined{}, nullptr));
+
+    // 对象按引用比较
+    auto object = createObject();
+    assert(strictEquals(object, object) && !strictEquals(object, createObject()));
+
+    // 驻留字符串之间只比较指针
+    auto a = internString("region");
+    assert(strictEquals(a, internString("region")) && !strictEquals(a, internString("regiom")));
+    assert(strictEquals(a, createString("region")));
+
+    // 以严格相等为键分组
+    std::unordered_map<ValueVariant, int, ValueHash, ValueEqual> counts;
+    ValueVariant keys[] = {createString("a"), createString("b"), createString("a"),
+                           int32_t(2), 2.0, uint64_t(2)};
+    for (const auto &key : keys) ++counts[key];
+    assert(counts.size() == 3 && counts[createString("a")] == 2 && counts[int32_t(2)] == 3);
+    std::cout << "分组数: " << counts.size() << std::endl;
+}
+
 void testArray() {
     std::cout << "\n=== 测试数组 ===" << std::endl;
     
@@ -51,7 +482,7 @@ void testArray() {
     std::cout << "空数组长度: " << valueToString(arr->getProperty("length")) << std::endl;
     
     // 测试push
-    auto pushFunc = std::get<std::shared_ptr<JFunction>>(arr->getProperty("push"));
+    auto pushFunc = std::get<Ref<JFunction>>(arr->getProperty("push"));
     pushFunc->Call({static_cast<int32_t>(1), static_cast<int32_t>(2), static_cast<int32_t>(3)});
     std::cout << "push后长度: " << valueToString(arr->getProperty("length")) << std::endl;
     std::cout << "数组内容: " << arr->toString() << std::endl;
@@ -61,12 +492,465 @@ void testArray() {
     std::cout << "arr[1]: " << valueToString(arr->At(1)) << std::endl;
     
     // 测试pop
-    auto popFunc = std::get<std::shared_ptr<JFunction>>(arr->getProperty("pop"));
+    auto popFunc = std::get<Ref<JFunction>>(arr->getProperty("pop"));
     auto poppedValue = popFunc->Call({});
     std::cout << "pop的值: " << valueToString(poppedValue) << std::endl;
     std::cout << "pop后数组: " << arr->toString() << std::endl;
 }
 
+void testElementsKind() {
+    std::cout << "\n=== 测试数组元素种类 ===" << std::endl;
+
+    auto doubles = createArray();
+    for (int i = 0; i < 1000; ++i) doubles->Push(i * 0.5);
+    assert(doubles->elementsKind() == ElementsKind::Double);
+    const double* raw = doubles->packedData<double>();
+    assert(raw && raw[10] == 5.0 && !doubles->packedData<int32_t>());
+    assert(std::get<double>(doubles->At(3)) == 1.5);
+
+    // 同构切片保持紧密存储
+    auto page = doubles->Slice(100, 110);
+    assert(page->elementsKind() == ElementsKind::Double && page->Size() == 10);
+
+    // 写入其他类型后转为通用存储，已有元素的类型保持不变
+    auto ints = createArray();
+    ints->Push(static_cast<int32_t>(1));
+    ints->Push(static_cast<int32_t>(2));
+    assert(ints->elementsKind() == ElementsKind::Int32);
+    ints->Push(static_cast<uint32_t>(3));
+    assert(ints->elementsKind() == ElementsKind::Generic);
+    assert(getValueType(ints->At(0)) == ValueType::Int32);
+    assert(getValueType(ints->At(2)) == ValueType::UInt32);
+
+    // 越界写入留下的少量空位留在连续存储中，同样转为通用存储
+    auto big = createArray();
+    big->Push(static_cast<uint64_t>(1) << 40);
+    assert(big->elementsKind() == ElementsKind::UInt64);
+    big->setElement(3, static_cast<uint64_t>(7));
+    assert(big->elementsKind() == ElementsKind::Generic);
+    assert(jvalue(big)[1].isUndefined() && !big->Has(1) && big->Size() == 4);
+    assert(big->NextIndex(1) == 3);
+    big->setElement(1, static_cast<uint64_t>(2));
+    assert(big->Has(1) && !big->Has(2));
+
+    big->Clear();
+    assert(big->elementsKind() == ElementsKind::Empty);
+    std::cout << "double 数组: " << page->toString() << std::endl;
+}
+
+void testArrayQueue() {
+    std::cout << "\n=== 测试数组队列 ===" << std::endl;
+
+    // 作为队列使用：尾部追加、头部取出，元素顺序与种类保持不变
+    auto queue = createArray();
+    for (int32_t i = 0; i < 1000; ++i) queue->Push(i);
+    for (int32_t i = 0; i < 100000; ++i) {
+        assert(std::get<int32_t>(queue->Shift()) == i);
+        queue->Push(i + 1000);
+    }
+    assert(queue->Size() == 1000 && queue->elementsKind() == ElementsKind::Int32);
+    assert(queue->packedData<int32_t>()[0] == 100000);
+
+    // 连续头部插入
+    auto stack = createArray();
+    for (int32_t i = 0; i < 1000; ++i) {
+        ValueVariant item = i;
+        stack->Unshift(&item, 1);
+    }
+    assert(std::get<int32_t>(stack->Front()) == 999 && std::get<int32_t>(stack->Back()) == 0);
+
+    // 头部插入后转为通用存储，之后仍可在两端操作
+    ValueVariant text = createString("head");
+    stack->Unshift(&text, 1);
+    assert(stack->elementsKind() == ElementsKind::Generic);
+    assert(valueToString(stack->Shift()) == "head");
+    assert(std::get<int32_t>(stack->Shift()) == 999 && stack->Size() == 999);
+
+    // 靠近头部的删除与插入
+    auto items = createArray();
+    for (int32_t i = 0; i < 10; ++i) items->Push(i);
+    ValueVariant inserted[] = {static_cast<int32_t>(-1), static_cast<int32_t>(-2)};
+    auto removed = items->Splice(1, 2, inserted, 2);
+    assert(removed->toString() == "1,2");
+    assert(items->toString() == "0,-1,-2,3,4,5,6,7,8,9");
+    items->Splice(2, 1, nullptr, 0);
+    assert(items->toString() == "0,-1,3,4,5,6,7,8,9");
+    while (!items->Empty()) items->Shift();
+    items->Push(static_cast<int32_t>(42));
+    assert(items->toString() == "42");
+    std::cout << "队列长度: " << queue->Size() << std::endl;
+}
+
+void testChunkedArray() {
+    std::cout << "\n=== 测试分块数组 ===" << std::endl;
+
+    // 大数组中间 splice 后转为分块存储，结果与逐个搬移的参考实现一致
+    const int32_t kSize = 50000;
+    auto arr = createArray();
+    std::vector<int32_t> expected;
+    for (int32_t i = 0; i < kSize; ++i) {
+        arr->Push(i);
+        expected.push_back(i);
+    }
+    uint32_t seed = 12345;
+    auto next = [&seed]() { return seed = seed * 1103515245 + 12345; };
+    for (int32_t round = 0; round < 2000; ++round) {
+        const size_t start = next() % expected.size();
+        const size_t deleteCount = std::min<size_t>(next() % 5, expected.size() - start);
+        const size_t insertCount = next() % 6;
+        std::vector<ValueVariant> items;
+        for (size_t i = 0; i < insertCount; ++i) {
+            items.push_back(static_cast<int32_t>(-round));
+        }
+        auto removed = arr->Splice(start, deleteCount, items.data(), items.size());
+        assert(removed->Size() == deleteCount);
+        for (size_t i = 0; i < deleteCount; ++i) {
+            assert(std::get<int32_t>(removed->At(i)) == expected[start + i]);
+        }
+        expected.erase(expected.begin() + start, expected.begin() + start + deleteCount);
+        expected.insert(expected.begin() + start, insertCount, -round);
+    }
+    assert(arr->elementsKind() == ElementsKind::Chunked);
+    assert(arr->Size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        assert(std::get<int32_t>(arr->At(i)) == expected[i]);
+    }
+
+    // 多个线程同时读取不同位置
+    std::atomic<bool> mismatch{false};
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            for (size_t i = t; i < expected.size(); i += 997) {
+                if (std::get<int32_t>(arr->At(i)) != expected[i]) mismatch = true;
+            }
+        });
+    }
+    for (auto &reader : readers) reader.join();
+    assert(!mismatch);
+    auto middle = arr->Slice(20000, 20100);
+    assert(middle->Size() == 100 && std::get<int32_t>(middle->At(99)) == expected[20099]);
+
+    // 分块存储下的两端操作与长度修改
+    arr->Push(createString("tail"));
+    assert(valueToString(arr->Back()) == "tail");
+    assert(valueToString(arr->Pop()) == "tail");
+    assert(std::get<int32_t>(arr->Shift()) == expected.front());
+    arr->setProperty("length", static_cast<uint32_t>(30000));
+    assert(arr->Size() == 30000);
+    assert(std::get<int32_t>(arr->At(29999)) == expected[30000]);
+
+    // 缩小后回到连续存储，同构数值重新紧密保存
+    arr->Splice(100, 29000, nullptr, 0);
+    assert(arr->Size() == 1000 && arr->elementsKind() == ElementsKind::Int32);
+    assert(std::get<int32_t>(arr->At(100)) == expected[29101]);
+    std::cout << "分块数组 splice 后长度: " << expected.size() << std::endl;
+}
+
+void testArraySliceSharing() {
+    std::cout << "\n=== 测试数组切片共享 ===" << std::endl;
+
+    // 切片共享原数组的缓冲区，不复制元素也不增加元素的引用计数
+    auto item = createObject();
+    auto outside = createObject();
+    auto arr = createArray();
+    for (int32_t i = 0; i < 1000; ++i) {
+        if (i == 500) arr->Push(item);
+        else if (i == 999) arr->Push(outside);
+        else arr->Push(i);
+    }
+    assert(item->refCount() == 2);
+    auto page = arr->Slice(400, 600);
+    assert(item->refCount() == 2);
+    assert(page->Size() == 200 && std::get<int32_t>(page->At(0)) == 400);
+    assert(std::get<Ref<JObject>>(page->At(100)).get() == item.get());
+
+    // 原数组写入时复制，切片内容不变
+    arr->setElement(450, createString("changed"));
+    assert(std::get<int32_t>(page->At(50)) == 450);
+    assert(valueToString(arr->At(450)) == "changed");
+    assert(item->refCount() == 3);
+
+    // 切片写入时复制，原数组不受影响
+    auto second = arr->Slice(0, 100);
+    second->Push(static_cast<int32_t>(-1));
+    assert(second->Size() == 101 && arr->Size() == 1000);
+    assert(std::get<int32_t>(arr->At(100)) == 100);
+
+    // 只剩切片持有缓冲区时直接接管，释放切片之外的元素
+    assert(outside->refCount() == 3);
+    page = arr->Slice(490, 530);
+    arr = nullptr;
+    assert(outside->refCount() == 2); // 原数组的缓冲区仍被新切片持有
+    page->Push(static_cast<int32_t>(7));
+    assert(outside->refCount() == 1 && item->refCount() == 2);
+    assert(std::get<Ref<JObject>>(page->At(10)).get() == item.get());
+    page = nullptr;
+    assert(item->refCount() == 1);
+
+    // 多个线程同时从同一个数组切片，最后释放的切片析构共享的元素
+    auto source = createArray();
+    auto marker = createObject();
+    for (int32_t i = 0; i < 256; ++i) {
+        if (i == 100) source->Push(marker);
+        else source->Push(createString("item"));
+    }
+    std::vector<Ref<JArray>> pages(4);
+    std::vector<std::thread> slicers;
+    for (size_t t = 0; t < pages.size(); ++t) {
+        slicers.emplace_back([&, t]() {
+            for (int i = 0; i < 200; ++i) pages[t] = source->Slice(64, 192);
+        });
+    }
+    for (auto &slicer : slicers) slicer.join();
+    source = nullptr;
+    assert(marker->refCount() == 2);
+    pages.clear();
+    assert(marker->refCount() == 1);
+
+    // 同构数值数组的切片仍可直接访问连续数据
+    auto doubles = createArray();
+    for (int i = 0; i < 100; ++i) doubles->Push(i * 0.25);
+    auto tail = doubles->Slice(60, 100);
+    assert(tail->packedData<double>()[0] == 15.0);
+    doubles->Clear();
+    assert(std::get<double>(tail->At(39)) == 24.75);
+    std::cout << "切片长度: " << tail->Size() << std::endl;
+}
+
+void testSparseArray() {
+    std::cout << "\n=== 测试稀疏数组 ===" << std::endl;
+
+    // 远超长度的下标只记录长度，不按下标分配
+    auto arr = createArray();
+    arr->Push(static_cast<int32_t>(1));
+    jvalue view(arr);
+    view[4000000000u] = static_cast<int32_t>(2);
+    assert(arr->elementsKind() == ElementsKind::Sparse);
+    assert(arr->Size() == 4000000001u);
+    assert(std::get<int32_t>(arr->At(4000000000u)) == 2);
+    assert(arr->At(12345).index() == static_cast<size_t>(ValueType::Undefined));
+    assert(arr->hasProperty("0") && !arr->hasProperty("1"));
+    assert(arr->hasProperty("4000000000"));
+
+    // 按属性名写入同样走元素存储
+    arr->setProperty("70000", createString("mid"));
+    auto names = arr->getPropertyNames();
+    assert((names == std::vector<std::string>{"0", "70000", "4000000000"}));
+
+    // 迭代只访问存在的元素
+    std::vector<size_t> visited;
+    for (size_t i = arr->NextIndex(0); i < arr->Size(); i = arr->NextIndex(i + 1)) {
+        visited.push_back(i);
+    }
+    assert((visited == std::vector<size_t>{0, 70000, 4000000000u}));
+    size_t iterated = 0;
+    for (auto element : jarray(view)) {
+        assert(!element.isUndefined());
+        ++iterated;
+    }
+    assert(iterated == 3);
+
+    // 头部插入删除整体移动下标
+    arr->Shift();
+    assert(std::get<int32_t>(arr->At(3999999999u)) == 2 && !arr->Has(0));
+    ValueVariant head = static_cast<int32_t>(9);
+    arr->Unshift(&head, 1);
+    assert(std::get<int32_t>(arr->At(0)) == 9 && arr->Has(70000));
+
+    // 缩短长度后空位填满即回到连续存储
+    arr->setProperty("length", static_cast<uint32_t>(2));
+    assert(arr->Size() == 2 && arr->elementsKind() == ElementsKind::Sparse);
+    arr->setElement(1, static_cast<int32_t>(5));
+    assert(arr->elementsKind() == ElementsKind::Int32);
+    assert(std::get<int32_t>(arr->At(1)) == 5);
+
+    // 稀疏切片
+    auto ids = createArray();
+    ids->setElement(100000, createString("a"));
+    ids->setElement(100002, createString("b"));
+    auto part = ids->Slice(100001, 100003);
+    assert(part->Size() == 2 && !part->Has(0) && part->Has(1));
+    std::cout << "稀疏数组长度: " << arr->Size() << ", 切片: " << part->Size() << std::endl;
+
+    // 构造与扩展长度得到的都是空位，与长度无关；预留的空位保持连续存储，
+    // 按下标逐个填入不经过稀疏存储
+    for (size_t n : {size_t(10), size_t(5000)}) {
+        auto holes = createArray(n);
+        assert(holes->elementsKind() != ElementsKind::Sparse);
+        assert(holes->Size() == n && !holes->Has(0) && !holes->Has(n - 1));
+        assert(holes->getPropertyNames().empty() && holes->NextIndex(0) == n);
+        holes->setProperty("length", static_cast<uint32_t>(n + 2));
+        assert(holes->Size() == n + 2 && !holes->hasProperty("0"));
+        for (size_t i = 0; i < n; ++i) holes->setElement(i, static_cast<double>(i));
+        assert(holes->elementsKind() == ElementsKind::Generic);
+        assert(holes->Has(n - 1) && !holes->Has(n) && holes->NextIndex(n) == n + 2);
+    }
+
+    // 紧密数组末尾之后隔一个下标写入：只留一个空位，不转为稀疏存储
+    auto doubles = createArray();
+    for (int i = 0; i < 20000; ++i) doubles->Push(i * 0.5);
+    doubles->setElement(doubles->Size() + 1, 1.0);
+    assert(doubles->elementsKind() == ElementsKind::Generic);
+    assert(doubles->Size() == 20002 && !doubles->Has(20000) && doubles->Has(20001));
+
+    // 分块存储同样以空位扩展长度，缩短后回到连续存储时保留空位
+    doubles->Splice(10000, 1, nullptr, 0);
+    assert(doubles->elementsKind() == ElementsKind::Chunked);
+    doubles->setElement(20003, 2.0);
+    assert(doubles->elementsKind() == ElementsKind::Chunked && !doubles->Has(20002));
+    doubles->Splice(0, 19000, nullptr, 0);
+    assert(doubles->elementsKind() == ElementsKind::Generic);
+    assert(doubles->Size() == 1004 && !doubles->Has(999) && !doubles->Has(1002));
+    assert(doubles->Has(1000) && doubles->Has(1003));
+
+    // 只有空位远多于元素的写入才转为稀疏存储
+    auto sparseIds = createArray();
+    sparseIds->Push(static_cast<int32_t>(1));
+    sparseIds->setElement(1024, static_cast<int32_t>(2));
+    assert(sparseIds->elementsKind() == ElementsKind::Generic);
+    sparseIds->setElement(10000, static_cast<int32_t>(3));
+    assert(sparseIds->elementsKind() == ElementsKind::Sparse && sparseIds->Has(1024) && !sparseIds->Has(1023));
+}
+
+void testArrayIndexLimits() {
+    std::cout << "\n=== 测试数组下标上限 ===" << std::endl;
+
+    // 最大下标 2^32 - 2 对应长度 2^32 - 1
+    auto arr = createArray();
+    arr->setProperty("4294967294", static_cast<int32_t>(1));
+    assert(arr->Size() == 4294967295u);
+    assert(std::get<uint32_t>(arr->getProperty("length")) == 4294967295u);
+
+    // 更大的数字属性名按普通属性保存，不影响长度
+    auto named = createArray();
+    named->setProperty("4294967295", static_cast<int32_t>(2));
+    named->setElement(SIZE_MAX, static_cast<int32_t>(3));
+    assert(named->Size() == 0 && std::get<uint32_t>(named->getProperty("length")) == 0);
+    assert(std::get<int32_t>(named->getProperty("4294967295")) == 2);
+    assert(std::get<int32_t>(named->At(SIZE_MAX)) == 3);
+    assert((named->getPropertyNames() ==
+            std::vector<std::string>{"4294967295", std::to_string(SIZE_MAX)}));
+
+    // 长度达到上限后继续追加抛出异常，长度不回绕
+    bool threw = false;
+    try {
+        arr->Push(static_cast<int32_t>(2));
+    } catch (const std::length_error &) {
+        threw = true;
+    }
+    assert(threw && arr->Size() == 4294967295u);
+    std::cout << "最大长度: " << arr->Size() << std::endl;
+}
+
+void testIntrinsicProperties() {
+    std::cout << "\n=== 测试内在属性 ===" << std::endl;
+
+    // 构造时不创建实例属性，所有实例停留在根 Shape
+    auto str = createString("abc");
+    auto arr = createArray(2);
+    auto fn = createFunction("f");
+    assert(str->shape() == Shape::root() && arr->shape() == Shape::root());
+    assert(fn->shape() == Shape::root());
+
+    const Atom length = Atom::intern("length");
+    assert(std::get<uint32_t>(str->getProperty(length)) == 3);
+    assert(str->hasProperty(length) && !str->setProperty("length", 1u));
+    assert(valueToString(fn->getProperty("name")) == "f");
+
+    // 数组 length 可写，按原子写入同样改变数组长度
+    jvalue view(arr);
+    view[length] = static_cast<uint32_t>(5);
+    assert(arr->Size() == 5 && !arr->shape()->propertyCount());
+    assert(evalValue(jvalue(arr), compilePath("length")).to<uint32_t>() == 5);
+    std::cout << "字符串长度: " << valueToString(str->getProperty(length))
+              << ", 数组长度: " << arr->Size() << std::endl;
+}
+
+void testPrototype() {
+    std::cout << "\n=== 测试原型链 ===" << std::endl;
+
+    auto arr = createArray();
+    auto push1 = std::get<Ref<JFunction>>(arr->getProperty("push"));
+    auto push2 = std::get<Ref<JFunction>>(arr->getProperty("push"));
+    assert(push1 == push2);
+    push1->Call({static_cast<int32_t>(7)});
+    std::cout << "重复读取push复用同一函数: " << (push1 == push2 ? "是" : "否")
+              << ", 数组: " << arr->toString() << std::endl;
+
+    // 多线程同时读取同一对象的方法：各线程得到同一个绑定函数
+    auto shared = createArray();
+    const std::array<const char *, 4> names = {"push", "pop", "slice", "toString"};
+    std::array<JFunction *, 4> seen[4] = {};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < names.size(); ++i) {
+                seen[t][i] = std::get<Ref<JFunction>>(shared->getProperty(names[i])).get();
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    for (int t = 1; t < 4; ++t) assert(seen[t] == seen[0]);
+
+    // 数组 C++ 方法
+    auto queue = createArray();
+    for (int32_t i = 0; i < 5; ++i) queue->Push(i);
+    ValueVariant front[] = {static_cast<int32_t>(-1)};
+    queue->Unshift(front, 1);
+    assert(valueToString(queue->Shift()) == "-1");
+    auto removed = queue->Splice(1, 2, front, 1);
+    assert(removed->toString() == "1,2" && queue->toString() == "0,-1,3,4");
+    assert(queue->Slice(1, 3)->toString() == "-1,3");
+
+    // 原型上的共享方法以显式接收者调用
+    auto sharedPush = std::get<Ref<JFunction>>(
+        JArray::prototype()->getProperty("push"));
+    sharedPush->Call(*arr, {static_cast<int32_t>(8)});
+    assert(arr->Size() == 2);
+
+    // 自有属性优先于原型
+    auto str = createString("abc");
+    str->setProperty("indexOf", static_cast<int32_t>(1));
+    assert(valueToString(str->getProperty("indexOf")) == "1");
+    assert(valueToString(arr->getProperty("toString")) != "undefined");
+}
+
+void testBuiltinTable() {
+    std::cout << "\n=== 测试内置名完美哈希表 ===" << std::endl;
+
+    // 表在编译期生成，查找同样可以在编译期求值
+    static constexpr BuiltinTable table(std::array<std::string_view, 4>{"push", "pop", "shift", "slice"});
+    static_assert(table.find("pop") == 1 && table.find("slice") == 3);
+    static_assert(table.find("splice") == BuiltinTable<4>::kNotFound && table.find("") == BuiltinTable<4>::kNotFound);
+    assert(table.index().find("shift", hashBuiltinName("shift")) == 2);
+
+    // 用户属性与内置名都经由同一次哈希判定
+    auto str = createString("abc");
+    auto date = createDate();
+    assert(std::holds_alternative<JUndefined>(str->getProperty("customerId")));
+    assert(std::holds_alternative<Ref<JFunction>>(str->getProperty("codePointAt")));
+    assert(std::holds_alternative<Ref<JFunction>>(date->getProperty("toString")));
+
+    // 原型增删属性后改走常规查找，删除后恢复
+    auto proto = JDate::prototype();
+    proto->setProperty("zone", createString("UTC"));
+    assert(valueToString(date->getProperty("zone")) == "UTC");
+    assert(std::holds_alternative<Ref<JFunction>>(date->getProperty("getTime")));
+    proto->deleteProperty("zone");
+    assert(std::holds_alternative<JUndefined>(date->getProperty("zone")));
+    assert(std::holds_alternative<Ref<JFunction>>(date->getProperty("setTime")));
+
+    // 覆盖内置方法的值不改变 Shape，读取得到新值
+    const ValueVariant original = proto->getProperty("setTime");
+    proto->setProperty("setTime", static_cast<int32_t>(0));
+    assert(valueToString(createDate()->getProperty("setTime")) == "0");
+    proto->setProperty("setTime", original);
+    assert(std::holds_alternative<Ref<JFunction>>(createDate()->getProperty("setTime")));
+    std::cout << "String.prototype 方法查找: "
+              << std::get<Ref<JFunction>>(str->getProperty("split"))->getName() << std::endl;
+}
+
 void testObject() {
     std::cout << "\n=== 测试对象 ===" << std::endl;
     
@@ -82,7 +966,7 @@ void testObject() {
     std::cout << "active: " << valueToString(obj->getProperty("active")) << std::endl;
     
     // 测试operator[]
-    std::cout << "obj[\"name\"]: " << valueToString(obj->operator[]("name")) << std::endl;
+    std::cout << "obj[\"name\"]: " << valueToString(jvalue(obj)["name"]) << std::endl;
     
     // 测试属性枚举
     auto propNames = obj->getPropertyNames();
@@ -93,6 +977,247 @@ void testObject() {
     std::cout << std::endl;
 }
 
+void testShape() {
+    std::cout << "\n=== 测试隐藏类 ===" << std::endl;
+
+    auto a = createObject();
+    auto b = createObject();
+    a->setProperty("x", static_cast<int32_t>(1));
+    a->setProperty("y", static_cast<int32_t>(2));
+    b->setProperty("x", static_cast<int32_t>(3));
+    b->setProperty("y", static_cast<int32_t>(4));
+    assert(a->shape() == b->shape());
+    std::cout << "相同键序列共享Shape: " << (a->shape() == b->shape() ? "是" : "否") << std::endl;
+
+    // 删除末尾属性回退到父Shape
+    b->deleteProperty("y");
+    assert(b->shape() && b->shape() == a->shape()->parent());
+
+    // 删除中间属性转为字典模式，属性与顺序保持不变
+    a->setProperty("z", static_cast<int32_t>(5));
+    a->keepOrder(true);
+    a->deleteProperty("x");
+    assert(!a->shape());
+    std::cout << "字典模式属性: ";
+    for (const auto& name : a->getPropertyNames()) {
+        std::cout << name << "=" << valueToString(a->getProperty(name)) << " ";
+    }
+    std::cout << std::endl;
+    assert(valueToString(a->getProperty("z")) == "5");
+
+    // 小 Shape 线性查找，超过阈值后建立索引；两种情况下查找结果一致
+    auto wide = createObject();
+    for (int32_t i = 0; i < 12; ++i) {
+        wide->setProperty("f" + std::to_string(i), i);
+        for (int32_t j = 0; j <= i; ++j) {
+            const std::string key = "f" + std::to_string(j);
+            assert(std::get<int32_t>(wide->getProperty(key)) == j);
+            assert(std::get<int32_t>(wide->getProperty(Atom::intern(key))) == j);
+        }
+        assert(!wide->hasProperty("g") && !wide->hasProperty(Atom::intern("g")));
+    }
+    assert(wide->shape()->propertyCount() == 12);
+}
+
+void testDictionary() {
+    std::cout << "\n=== 测试有序字典 ===" << std::endl;
+
+    // 超过快速模式上限后转为字典模式，枚举仍保持插入顺序
+    auto obj = createObject();
+    for (int32_t i = 0; i < 2000; ++i) {
+        obj->setProperty("k" + std::to_string(i), i);
+    }
+    assert(!obj->shape());
+    for (int32_t i = 0; i < 2000; i += 2) {
+        assert(obj->deleteProperty("k" + std::to_string(i)));
+    }
+    assert(!obj->deleteProperty("k0") && !obj->hasProperty("k10"));
+    obj->setProperty("k0", static_cast<int32_t>(-1));
+
+    auto names = obj->getPropertyNames();
+    assert(names.size() == 1001);
+    assert(names[0] == "k1" && names[999] == "k1999" && names[1000] == "k0");
+    assert(valueToString(obj->getProperty("k1999")) == "1999");
+
+    // 原子查找复用预计算哈希
+    assert(valueToString(obj->getProperty(Atom::intern("k1001"))) == "1001");
+
+    // 不可配置的属性不能删除
+    def_prop_val(*obj, "fixed", static_cast<int32_t>(1), false, true, false);
+    assert(!obj->deleteProperty("fixed") && obj->hasProperty("fixed"));
+    std::cout << "字典属性数: " << obj->getPropertyNames().size() << std::endl;
+}
+
+void testAtom() {
+    std::cout << "\n=== 测试属性名原子 ===" << std::endl;
+
+    const Atom id = Atom::intern("id");
+    assert(id == Atom::intern(std::string("id")));
+    assert(Atom::find("id") == id);
+    assert(!Atom::find("never-interned-key").valid());
+    assert(Atom::intern("42").isArrayIndex() && !id.isArrayIndex());
+
+    auto obj = createObject();
+    obj->setProperty(id, static_cast<int32_t>(7));
+    assert(obj->hasProperty("id") && obj->hasProperty(id));
+    assert(valueToString(obj->getProperty(id)) == "7");
+    jvalue root(obj);
+    root[id] = static_cast<int32_t>(8);
+    std::cout << "id: " << valueToString(obj->getProperty("id")) << std::endl;
+
+    // 原型上的方法同样可以按原子读取
+    auto arr = createArray();
+    assert(std::holds_alternative<Ref<JFunction>>(
+        arr->getProperty(Atom::intern("push"))));
+    assert(obj->deleteProperty(id) && !obj->hasProperty(id));
+
+    // 只读访问不驻留新的属性名，写回时才驻留
+    assert(root["read-only-key"].isUndefined() && root[123456789u].isUndefined());
+    assert(!Atom::find("read-only-key").valid() && !Atom::find("123456789").valid());
+    const bool interned = Atom::find("charCodeAt").valid();
+    assert(std::holds_alternative<Ref<JFunction>>(jvalue(createString("s"))["charCodeAt"].getValue()));
+    assert(Atom::find("charCodeAt").valid() == interned);
+    root["written-key"] = static_cast<int32_t>(9);
+    assert(Atom::find("written-key").valid() && valueToString(obj->getProperty("written-key")) == "9");
+
+    // 字典模式对象的属性名不经原子保存，迭代时同样不驻留
+    auto dict = createObject();
+    dict->setProperty("a", static_cast<int32_t>(1));
+    dict->setProperty("b", static_cast<int32_t>(1));
+    dict->deleteProperty("a");
+    dict->setProperty("dict-only-key", static_cast<int32_t>(2));
+    assert(!Atom::find("dict-only-key").valid());
+    for (auto [name, value] : jvalue(dict).properties()) {
+        if (name == "dict-only-key") value = static_cast<int32_t>(3);
+    }
+    assert(!Atom::find("dict-only-key").valid());
+    assert(valueToString(dict->getProperty("dict-only-key")) == "3");
+}
+
+void testCompiledPath() {
+    std::cout << "\n=== 测试预编译路径 ===" << std::endl;
+
+    auto path = compilePath("user.tags[1].length");
+    for (int i = 0; i < 3; ++i) {
+        auto tags = createArray();
+        tags->Push(createString("a"));
+        tags->Push(createString(std::string(i + 1, 'b')));
+        auto user = createObject();
+        user->setProperty("tags", tags);
+        auto root = createObject();
+        root->setProperty("user", user);
+
+        auto fast = evalValue(jvalue(root), path);
+        auto slow = evalValue(jvalue(root), "user.tags[1].length");
+        assert(valueToString(fast) == valueToString(slow));
+        std::cout << "第" << i << "次: " << valueToString(fast) << std::endl;
+    }
+
+    // 缓存命中后返回的 jvalue 仍可回写属性
+    auto obj = createObject();
+    obj->setProperty("count", static_cast<int32_t>(1));
+    auto countPath = compilePath("count");
+    evalValue(jvalue(obj), countPath);
+    evalValue(jvalue(obj), countPath) = static_cast<int32_t>(2);
+    assert(valueToString(obj->getProperty("count")) == "2");
+    assert(evalValue(jvalue(obj), compilePath("missing.x")).isUndefined());
+}
+
+void testJSON() {
+    std::cout << "\n=== 测试 JSON 解析 ===" << std::endl;
+
+    auto root = parseJSON(R"( {
+        "name": "jobject", "version": 3, "big": 5000000000,
+        "ratio": -1.5e2, "tags": ["a\n\"b\"", "\u00e9\ud83d\ude00"],
+        "nested": {"ok": true, "none": null, "list": [1, 2, 3]},
+        "name": "dup"
+    } )");
+    auto obj = toJObject(root);
+    assert(obj);
+    assert(valueToString(obj->getProperty("name")) == "dup");
+    assert(std::get<int32_t>(obj->getProperty("version")) == 3);
+    assert(std::get<uint64_t>(obj->getProperty("big")) == 5000000000ull);
+    assert(std::get<double>(obj->getProperty("ratio")) == -150.0);
+
+    auto tags = toJArray(obj->getProperty("tags"));
+    assert(tags && tags->Size() == 2);
+    assert(valueToString(tags->At(0)) == "a\n\"b\"");
+    assert(valueToString(tags->At(1)) == "\xC3\xA9\xF0\x9F\x98\x80");
+
+    auto list = evalValue(jvalue(root), "nested.list");
+    assert(toJArray(list)->elementsKind() == ElementsKind::Int32);
+    assert(evalValue(jvalue(root), "nested.none").isNull());
+
+    // 长字符串走向量化扫描路径
+    const std::string longText(1000, 'x');
+    auto longStr = toJString(parseJSON("\"" + longText + "\\t\""));
+    assert(longStr->getValue() == longText + "\t");
+
+    for (const char* bad : {"", "[1,]", "{\"a\" 1}", "01", "\"\x01\"", "[1] x"}) {
+        bool threw = false;
+        try {
+            parseJSON(bad);
+        } catch (const JSONParseError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    std::cout << "tags: " << tags->toString() << std::endl;
+}
+
+void testStringify() {
+    std::cout << "\n=== 测试 JSON 序列化 ===" << std::endl;
+
+    auto obj = createObject();
+    obj->setProperty("name", createString("a\"b\n"));
+    obj->setProperty("ratio", 0.1);
+    obj->setProperty("skip", JUndefined{});
+    obj->setProperty("fn", createFunction("f"));
+    def_prop_val(*obj, "hidden", static_cast<int32_t>(1), true, false, true);
+    auto list = createArray();
+    list->Push(static_cast<int32_t>(1));
+    list->Push(JUndefined{});
+    list->Push(std::nan(""));
+    obj->setProperty("list", list);
+    const std::string expected =
+        R"({"name":"a\"b\n","ratio":0.1,"list":[1,null,null]})";
+    assert(stringify(obj) == expected);
+
+    // 解析结果可以原样序列化回去
+    assert(stringify(parseJSON(expected)) == expected);
+
+    // 字典模式下按插入顺序输出
+    auto ordered = createObject();
+    ordered->keepOrder(true);
+    for (const char* key : {"z", "y", "x", "w"}) {
+        ordered->setProperty(key, static_cast<uint64_t>(1) << 40);
+    }
+    ordered->deleteProperty("y");
+    assert(!ordered->shape());
+    assert(stringify(ordered) ==
+           R"({"z":1099511627776,"x":1099511627776,"w":1099511627776})");
+
+    // 缓冲区可复用
+    JSONBufferSink sink(16);
+    stringify(list, sink);
+    sink.clear();
+    stringify(ordered, sink);
+    assert(sink.view() == stringify(ordered));
+
+    // 循环引用抛出异常
+    auto loop = createObject();
+    loop->setProperty("self", loop);
+    bool threw = false;
+    try {
+        stringify(loop);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    loop->deleteProperty("self");
+    std::cout << "序列化: " << expected << std::endl;
+}
+
 void testFunction() {
     std::cout << "\n=== 测试函数 ===" << std::endl;
     
@@ -120,7 +1245,7 @@ void testDate() {
     std::cout << "当前时间: " << date->toString() << std::endl;
     
     // 获取时间戳
-    auto getTimeFunc = std::get<std::shared_ptr<JFunction>>(date->getProperty("getTime"));
+    auto getTimeFunc = std::get<Ref<JFunction>>(date->getProperty("getTime"));
     auto timestamp = getTimeFunc->Call({});
     std::cout << "时间戳: " << valueToString(timestamp) << std::endl;
 }
@@ -161,6 +1286,36 @@ void testPropertyDescriptor() {
     // 尝试修改只读属性
     bool success = obj->setProperty("readonly", createString("尝试修改"));
     std::cout << "修改只读属性" << (success ? "成功" : "失败") << std::endl;
+    assert(!success);
+    assert(valueToString(obj->getProperty("readonly")) == "只读属性");
+    assert(!obj->deleteProperty("readonly"));
+
+    // 数据属性与访问器属性分开存储，普通数据属性只占紧凑的槽位
+    static_assert(sizeof(PropertySlot) <= 3 * sizeof(void*), "数据属性槽位应保持紧凑");
+    std::cout << "PropertySlot 大小: " << sizeof(PropertySlot) << " 字节" << std::endl;
+
+    // 访问器属性重新定义为数据属性后按值读写
+    PropertyDescriptor plain;
+    plain.value = 7;
+    plain.enumerable = false;
+    obj->defineProperty("special", plain);
+    assert(std::get<int32_t>(obj->getProperty("special")) == 7);
+    assert(obj->setProperty("special", 8));
+    assert(std::get<int32_t>(obj->getProperty("special")) == 8);
+    auto names = obj->getPropertyNames();
+    assert(std::find(names.begin(), names.end(), "special") == names.end());
+
+    // 只有 setter 的访问器读取时返回描述符中的值
+    int written = 0;
+    PropertyDescriptor setterOnly;
+    setterOnly.value = 1;
+    setterOnly.setter = [&written](const ValueVariant& value) {
+        written = std::get<int32_t>(value);
+    };
+    obj->defineProperty("sink", setterOnly);
+    assert(obj->setProperty("sink", 5));
+    assert(written == 5);
+    assert(std::get<int32_t>(obj->getProperty("sink")) == 1);
 }
 
 void testMacroUsage() {
@@ -174,7 +1329,7 @@ void testMacroUsage() {
     // 使用DEF_PROP宏定义读写属性
     def_prop_rw(*obj, "name", 
         []() -> ValueVariant {
-            return std::make_shared<JString>("test object");
+            return makeRef<JString>("test object");
         },
         [obj](const ValueVariant& val) {
             std::cout << "设置name属性为: " << utils::valueToString(val) << std::endl;
@@ -183,7 +1338,7 @@ void testMacroUsage() {
     // 使用DEF_PROP_RO宏定义只读属性
     def_prop_ro(*obj, "version",
         []() -> ValueVariant {
-            return std::make_shared<JString>("1.0.0");
+            return makeRef<JString>("1.0.0");
         });
     
     // 使用DEF_PROP_VAL宏定义值属性
@@ -195,7 +1350,7 @@ void testMacroUsage() {
     std::cout << "ID: " << utils::valueToString(obj->getProperty("id")) << std::endl;
     
     // 测试设置属性
-    obj->setProperty("name", std::make_shared<JString>("updated name"));
+    obj->setProperty("name", makeRef<JString>("updated name"));
     std::cout << "更新后的名称: " << utils::valueToString(obj->getProperty("name")) << std::endl;
 }
 
@@ -205,9 +1360,32 @@ int main() {
     
     try {
         testBasicTypes();
+        testCompactValue();
+        testRef();
         testString();
+        testRopeString();
+        testSubstring();
+        testStringSearch();
+        testUnicodeString();
+        testStringIntern();
+        testValueEquality();
         testArray();
+        testElementsKind();
+        testArrayQueue();
+        testChunkedArray();
+        testArraySliceSharing();
+        testSparseArray();
+        testArrayIndexLimits();
+        testIntrinsicProperties();
+        testPrototype();
+        testBuiltinTable();
         testObject();
+        testShape();
+        testDictionary();
+        testAtom();
+        testCompiledPath();
+        testJSON();
+        testStringify();
         testFunction();
         testDate();
         testPropertyDescriptor();